@@ -0,0 +1,95 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: Benchmark.h
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "Blocks/World/Chunk.h"
+
+// Headless benchmarks which can be run by starting the game with the --benchmark argument.
+// Results are written to the log.
+
+namespace Blocks::Benchmark
+{
+    /**
+     * \brief Written to by benchmarks so the compiler can not optimize the measured work away.
+     */
+    inline volatile uint64_t Sink = 0;
+
+    /**
+     * \brief A column of stacked chunks tall enough to contain the whole generated surface, so the benchmarks measure
+     * the same terrain for every chunk height. At least 4 sections, rounded up to a whole number of chunks.
+     */
+    using ColumnGeometry = ChunkGeometry<4, 4, 4, (4 + Chunk::SectionsPerChunk - 1) / Chunk::SectionsPerChunk
+                                         * Chunk::SectionsPerChunk, BLOCKS_CHUNK_LAYOUT>;
+
+    static_assert(ColumnGeometry::Height % Chunk::Height == 0, "A column must consist of whole chunks");
+
+    /**
+     * \brief Generates the chunks of a column from the chunk at y 0 upwards.
+     * \param x The x coordinate of the column in chunks.
+     * \param z The z coordinate of the column in chunks.
+     * \return The blocks of the column indexed by ColumnGeometry::GetFlatIndex.
+     */
+    std::vector<uint8_t> GenerateColumn(int x, int z);
+
+    /**
+     * \brief Runs every benchmark sequentially.
+     * \return The exit code of the application.
+     */
+    int RunAll();
+
+    /**
+     * \brief Compares the palette compressed chunk storage against a flat block array.
+     */
+    void RunBlockStorage();
+
+    /**
+     * \brief Measures neighbour queries and meshing for every chunk layout.
+     */
+    void RunChunkLayout();
+
+    /**
+     * \brief Measures the compression and the archive and expand latency of the voxel DAG on generated chunks.
+     */
+    void RunVoxelDag();
+
+    /**
+     * \brief Runs every mesher on the same generated sections and checks that they cover the same visible surface.
+     * Also measures the mesh cache on the generated and on superflat terrain, compares the collider boxes against the
+     * triangles of the meshes, simulates the vertex cache on the meshes, measures every level of detail and compares
+     * patching the mesh after single block edits against meshing the section again.
+     */
+    void RunMeshing();
+
+    /**
+     * \brief Measures the average duration of an operation.
+     * \param operation The operation to measure. It is executed once as warmup before measuring.
+     * \param iterations How many times the operation is executed.
+     * \return The average duration of a single execution in nanoseconds.
+     */
+    template <class Operation>
+    double Measure(Operation&& operation, const int iterations)
+    {
+        operation();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            operation();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    }
+}
@@ -0,0 +1,73 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: BlockPatch.h
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "BlocksEngine/Core/Math/Vector3.h"
+
+namespace Blocks
+{
+    class BlockPatch;
+}
+
+/**
+ * \brief A box of block ids that can be pasted into the world with World::ApplyPatch, e.g. a schematic.
+ * Blocks are stored row by row along the X axis, followed by Z and then Y.
+ */
+class Blocks::BlockPatch
+{
+public:
+    //------------------------------------------------------------------------------
+    // Constants
+    //------------------------------------------------------------------------------
+
+    /**
+     * \brief Blocks with this id leave the block in the world unchanged when the patch is applied.
+     */
+    static constexpr uint8_t Keep = 0xFF;
+
+
+    //------------------------------------------------------------------------------
+    // Constructors
+    //------------------------------------------------------------------------------
+
+    /**
+     * \brief Creates a patch where every block has the same id.
+     * \param size The number of blocks on each axis.
+     * \param blockId The initial id of all blocks.
+     */
+    explicit BlockPatch(BlocksEngine::Vector3<int> size, uint8_t blockId = Keep);
+
+
+    //------------------------------------------------------------------------------
+    // Methods
+    //------------------------------------------------------------------------------
+
+    [[nodiscard]] uint8_t Get(BlocksEngine::Vector3<int> position) const noexcept;
+    void Set(BlocksEngine::Vector3<int> position, uint8_t blockId) noexcept;
+
+    [[nodiscard]] BlocksEngine::Vector3<int> GetSize() const noexcept;
+
+    /**
+     * \brief The consecutive blocks along the X axis starting at the given position.
+     * \param position The first block of the row.
+     * \param length The number of blocks in the row.
+     */
+    [[nodiscard]] std::span<const uint8_t> GetRow(BlocksEngine::Vector3<int> position, int length) const noexcept;
+
+private:
+    BlocksEngine::Vector3<int> size_;
+    std::vector<uint8_t> blocks_;
+
+    [[nodiscard]] size_t GetIndex(BlocksEngine::Vector3<int> position) const noexcept;
+};
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <array>
 #include <robin_hood.h>
 
 #include "Blocks/World/Block.h"
@@ -21,6 +22,9 @@ namespace Blocks
 class Blocks::BlockRegistry
 {
 public:
+    using SeeThroughTable = std::array<bool, 256>;
+    using TextureTable = std::array<std::array<uint8_t, 6>, 256>;
+
     BlockRegistry(const BlockRegistry&) = delete;
     void operator=(const BlockRegistry&) = delete;
 
@@ -32,9 +36,23 @@ public:
     static const Block& GetBlock(uint8_t blockId);
     static const robin_hood::unordered_map<uint8_t, const Block&>& Blocks();
 
+    /**
+     * \brief Whether the faces behind a block can be seen, indexed by block id. Ids without a block are opaque.
+     * Meant for hot loops like the meshers, which look up the table once instead of every block.
+     */
+    static const SeeThroughTable& GetSeeThroughTable();
+
+    /**
+     * \brief The textures of every face of a block, indexed by block id. Ids without a block have the texture 0.
+     * Like the see-through table meant for the meshers, which write the textures of every quad.
+     */
+    static const TextureTable& GetTextureTable();
+
 private:
     static BlockRegistry& Instance();
     BlockRegistry();
 
     robin_hood::unordered_map<uint8_t, const Block&> blocks_;
+    SeeThroughTable seeThrough_{};
+    TextureTable textures_{};
 };
@@ -0,0 +1,107 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: BlockStorage.h
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Blocks
+{
+    class BlockStorage;
+}
+
+/**
+ * \brief Palette compressed storage for the block ids of a chunk section.
+ *
+ * Every distinct block id is stored once in a palette and each block only stores the index into that palette.
+ * The indices are bit packed using 0, 1, 2, 4 or 8 bits per block, depending on the size of the palette.
+ * As all of these widths divide 64, an index never spans two words.
+ * A storage with a single palette entry is uniform and does not allocate any index data.
+ */
+class Blocks::BlockStorage
+{
+public:
+    //------------------------------------------------------------------------------
+    // Constructors
+    //------------------------------------------------------------------------------
+
+    /**
+     * \brief Creates a uniform storage where every block has the same id.
+     * \param size The number of blocks in the storage.
+     * \param blockId The id every block is initialized with.
+     */
+    explicit BlockStorage(size_t size, uint8_t blockId = 0);
+
+    /**
+     * \brief Creates a storage from a flat array of block ids using the smallest possible palette.
+     * \param blocks The block ids, one per block.
+     */
+    explicit BlockStorage(std::span<const uint8_t> blocks);
+
+    //------------------------------------------------------------------------------
+    // Methods
+    //------------------------------------------------------------------------------
+
+    [[nodiscard]] uint8_t Get(size_t index) const noexcept;
+
+    /**
+     * \brief Sets the block id at the given index.
+     * If the id is not yet part of the palette it is added and the indices are repacked if required.
+     */
+    void Set(size_t index, uint8_t blockId);
+
+    /**
+     * \brief Sets every block to the same id and releases the index data.
+     */
+    void Fill(uint8_t blockId);
+
+    /**
+     * \brief Decodes all block ids sequentially into a flat array.
+     * \param destination The array to write to. Must be at least Size() long.
+     */
+    void CopyTo(std::span<uint8_t> destination) const noexcept;
+
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] bool IsUniform() const noexcept;
+    [[nodiscard]] uint8_t GetBitsPerBlock() const noexcept;
+    [[nodiscard]] const std::vector<uint8_t>& GetPalette() const noexcept;
+
+    /**
+     * \brief The number of bytes this storage occupies, including its heap allocations.
+     */
+    [[nodiscard]] size_t GetMemoryUsage() const noexcept;
+
+private:
+    size_t size_;
+    uint8_t bitsPerBlock_{0};
+    std::vector<uint8_t> palette_;
+    std::vector<uint64_t> data_{};
+
+    [[nodiscard]] static uint8_t BitsForPaletteSize(size_t paletteSize) noexcept;
+
+    [[nodiscard]] uint8_t GetPaletteIndex(size_t index) const noexcept;
+    void SetPaletteIndex(size_t index, uint8_t paletteIndex) noexcept;
+    void Repack(uint8_t bitsPerBlock);
+};
+
+inline uint8_t Blocks::BlockStorage::Get(const size_t index) const noexcept
+{
+    return palette_[GetPaletteIndex(index)];
+}
+
+inline uint8_t Blocks::BlockStorage::GetPaletteIndex(const size_t index) const noexcept
+{
+    if (bitsPerBlock_ == 0) return 0;
+
+    const size_t bit = index * bitsPerBlock_;
+    const uint64_t mask = (uint64_t{1} << bitsPerBlock_) - 1;
+    return static_cast<uint8_t>(data_[bit >> 6] >> (bit & 63) & mask);
+}
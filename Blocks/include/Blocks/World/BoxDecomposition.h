@@ -0,0 +1,129 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: BoxDecomposition.h
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "Block.h"
+
+namespace Blocks
+{
+    template <class Geometry>
+    class BoxDecomposition;
+}
+
+/**
+ * \brief Covers the solid blocks of a section with few axis aligned boxes, which are used as the shapes of its
+ * collider instead of a triangle mesh of its faces.
+ *
+ * Every block other than air is solid and the block types are ignored, so a section of stone and dirt is covered as a
+ * single body. The boxes are found greedily: a run of solid blocks along X is grown along Z and then along Y as long as
+ * every row it covers is solid, and the covered blocks are removed before the next run is searched. The boxes never
+ * overlap and cover exactly the solid blocks.
+ *
+ * \tparam Geometry The ChunkGeometry of the section.
+ */
+template <class Geometry>
+class Blocks::BoxDecomposition
+{
+public:
+    static_assert(Geometry::Width <= 64, "A row of a section must fit into a 64 bit mask");
+
+    /**
+     * \brief Decomposes the solid blocks of a section into boxes.
+     * \param getBlock Returns the block id at a position in the section.
+     * \param addBox Receives the inclusive lower and the exclusive upper corner of every box, relative to the section.
+     */
+    template <class GetBlock, class AddBox>
+    static void Decompose(const GetBlock& getBlock, const AddBox& addBox);
+
+private:
+    using RowMask = uint64_t;
+
+    // Bit x is set if the block at x of the row is solid, indexed by z + y * Depth
+    using RowMasks = std::array<RowMask, Geometry::SectionHeight * Geometry::Depth>;
+
+    [[nodiscard]] static constexpr int GetRowIndex(const int y, const int z) noexcept
+    {
+        return z + y * Geometry::Depth;
+    }
+
+    /**
+     * \brief Whether all the given bits are set in every row of a layer between z and endZ.
+     */
+    [[nodiscard]] static bool IsCovered(const RowMasks& rows, int y, int z, int endZ, RowMask run) noexcept;
+};
+
+template <class Geometry>
+template <class GetBlock, class AddBox>
+void Blocks::BoxDecomposition<Geometry>::Decompose(const GetBlock& getBlock, const AddBox& addBox)
+{
+    RowMasks rows{};
+    for (int y = 0; y < Geometry::SectionHeight; ++y)
+    {
+        for (int z = 0; z < Geometry::Depth; ++z)
+        {
+            RowMask& row = rows[GetRowIndex(y, z)];
+            for (int x = 0; x < Geometry::Width; ++x)
+            {
+                row |= static_cast<RowMask>(getBlock(x, y, z) != Block::Air.GetId()) << x;
+            }
+        }
+    }
+
+    for (int y = 0; y < Geometry::SectionHeight; ++y)
+    {
+        for (int z = 0; z < Geometry::Depth; ++z)
+        {
+            RowMask& row = rows[GetRowIndex(y, z)];
+            while (row != 0)
+            {
+                const int x = std::countr_zero(row);
+                const int width = std::countr_one(row >> x);
+                const RowMask run = (width == 64 ? ~RowMask{0} : (RowMask{1} << width) - 1) << x;
+
+                int endZ = z + 1;
+                while (endZ < Geometry::Depth && IsCovered(rows, y, endZ, endZ + 1, run))
+                {
+                    ++endZ;
+                }
+
+                int endY = y + 1;
+                while (endY < Geometry::SectionHeight && IsCovered(rows, endY, z, endZ, run))
+                {
+                    ++endY;
+                }
+
+                for (int by = y; by < endY; ++by)
+                {
+                    for (int bz = z; bz < endZ; ++bz)
+                    {
+                        rows[GetRowIndex(by, bz)] &= ~run;
+                    }
+                }
+
+                addBox(std::array<int, 3>{x, y, z}, std::array<int, 3>{x + width, endY, endZ});
+            }
+        }
+    }
+}
+
+template <class Geometry>
+bool Blocks::BoxDecomposition<Geometry>::IsCovered(const RowMasks& rows, const int y, const int z, const int endZ,
+                                                   const RowMask run) noexcept
+{
+    for (int i = z; i < endZ; ++i)
+    {
+        if ((rows[GetRowIndex(y, i)] & run) != run) return false;
+    }
+    return true;
+}
@@ -9,17 +9,29 @@
 
 #pragma once
 
+#include <atomic>
+#include <bitset>
+#include <functional>
+
 #include "Block.h"
+#include "BlockStorage.h"
+#include "ChunkGeometry.h"
+#include "SectionOccupancy.h"
+#include "VoxelDag.h"
+#include "Meshing/LevelOfDetail.h"
+#include "Meshing/MeshCache.h"
+#include "Meshing/Mesher.h"
+#include "Meshing/PaddedVolume.h"
+#include "Meshing/SectionQuads.h"
+#include "BlocksEngine/Core/Components/Collider.h"
 #include "BlocksEngine/Core/Components/Component.h"
 #include "BlocksEngine/Core/Components/Renderer.h"
 #include "BlocksEngine/Core/Dispatch/DispatchWorkGroup.h"
 #include "BlocksEngine/Core/Dispatch/DispatchWorkItem.h"
-#include "BlocksEngine/Core/Math/Vector2.h"
+#include "BlocksEngine/Core/Math/Vector3.h"
 #include "BlocksEngine/Graphics/Material/Texture2D.h"
 #include "BlocksEngine/Graphics/Material/Terrain/Terrain.h"
 
-// TODO: Split chunks into smaller sections of 16 height
-
 namespace Blocks
 {
     class World;
@@ -34,36 +46,51 @@ public:
     // Constants
     //------------------------------------------------------------------------------
 
+    /**
+     * \brief The compile time dimensions of a chunk. The height can be selected with BLOCKS_CHUNK_HEIGHT.
+     */
+    using Geometry = DefaultChunkGeometry;
+
     /**
      * \brief The number of blocks in a chunk on the X axis
      */
-    static constexpr int Width = 16;
+    static constexpr int Width = Geometry::Width;
 
     /**
      * \brief The number of blocks in a chunk on the Z axis
      */
-    static constexpr int Depth = 16;
+    static constexpr int Depth = Geometry::Depth;
 
     /**
      * \brief Each chunk is split into multiple sections stacked on top of each other.
      * The SectionHeight indicates the nr of blocks per section on the Y axis
      */
-    static constexpr int SectionHeight = 48;
+    static constexpr int SectionHeight = Geometry::SectionHeight;
 
     /**
      * \brief The number of sections to stack on top of each other per chunk
      */
-    static constexpr int SectionsPerChunk = 1;
+    static constexpr int SectionsPerChunk = Geometry::SectionsPerChunk;
 
     /**
      * \brief The total number of blocks in a chunk on the Y axis
      */
-    static constexpr int Height = SectionHeight * SectionsPerChunk;
+    static constexpr int Height = Geometry::Height;
+
+    /**
+     * \brief The number of blocks in a single section
+     */
+    static constexpr int SectionSize = Geometry::SectionSize;
 
     /**
      * \brief The total number of blocks in a chunk
      */
-    static constexpr int Size = Width * Depth * Height;
+    static constexpr int Size = Geometry::Size;
+
+    /**
+     * \brief The number of blocks on the six outer faces of a section, blocks on edges are stored once per face
+     */
+    static constexpr int BorderSize = 2 * (Width * SectionHeight + SectionHeight * Depth + Depth * Width);
 
 
     //------------------------------------------------------------------------------
@@ -74,6 +101,32 @@ public:
     class ChunkSection final : public Component
     {
     public:
+        //------------------------------------------------------------------------------
+        // Types
+        //------------------------------------------------------------------------------
+
+        /**
+         * \brief An immutable version of the blocks of a section.
+         *
+         * Writers never modify a published snapshot, they publish a new one with a higher version instead.
+         * Readers on any thread can therefore keep using a snapshot without holding a lock.
+         */
+        struct Snapshot
+        {
+            uint64_t version;
+
+            // Nullptr if the section only contains air
+            std::shared_ptr<const BlockStorage> blocks;
+
+            SectionOccupancy occupancy;
+
+            // The blocks of an archived section on its faces towards the section that is meshed, indexed by
+            // GetBorderIndex. Only set in the neighbourhood of a mesh job, never in a published snapshot, so archived
+            // sections are only stored in the DAG.
+            std::shared_ptr<const BlockStorage> border{nullptr};
+        };
+
+
         //------------------------------------------------------------------------------
         // Constructors
         //------------------------------------------------------------------------------
@@ -100,17 +153,182 @@ public:
 
         void Start() override;
         std::unique_ptr<BlocksEngine::DispatchWorkItem> RegenerateMesh();
+
+        /**
+         * \brief Removes the mesh and collider of this section. Used when a section no longer contains any blocks.
+         */
+        void ClearMesh();
+
+        /**
+         * \brief Updates the current mesh in place after a single block changed, without a mesh job.
+         * Must be called on the main thread after the block was published.
+         * Only the quads touching the faces of the block are replaced and uploaded, the collider boxes are rebuilt
+         * from the blocks in the background.
+         * \param position The changed block relative to this section, it can also lie in the border around it.
+         * \return False if the mesh could not be patched and the section has to be remeshed instead. This is the case
+         * if there is no mesh, a mesh job is pending, the mesh is shared with other sections or it became too
+         * fragmented.
+         */
+        bool PatchMesh(BlocksEngine::Vector3<int> position);
+
         void Enable() noexcept;
         void Disable() noexcept;
 
+        /**
+         * \brief Publishes new blocks for this section with the next version. Must be called on the main thread.
+         * \param blocks The new blocks or nullptr if the section only contains air.
+         */
+        void SetBlocks(std::shared_ptr<const BlockStorage> blocks);
+
+        /**
+         * \brief Publishes a copy of the blocks where a single block is replaced. Must be called on the main thread.
+         * \param position The position of the block in the section.
+         * \param blockId The new id of the block.
+         * \return False if the block already had the given id.
+         */
+        bool SetBlock(BlocksEngine::Vector3<int> position, uint8_t blockId);
+
+        /**
+         * \brief The currently published blocks of this section. Safe to call from any thread.
+         */
+        [[nodiscard]] std::shared_ptr<const Snapshot> GetSnapshot() const noexcept;
+
+        /**
+         * \brief The snapshot of this section for the neighbourhood of another section. Must be called on the main
+         * thread. An archived section gets the border of the faces that touch the other section expanded from the DAG.
+         * \param dx The x offset of this section from the other one, from -1 to 1.
+         * \param dy The y offset of this section from the other one, from -1 to 1.
+         * \param dz The z offset of this section from the other one, from -1 to 1.
+         */
+        [[nodiscard]] std::shared_ptr<const Snapshot> GetNeighbourSnapshot(int dx, int dy, int dz) const;
+
+        [[nodiscard]] uint64_t GetVersion() const noexcept;
+
+        /**
+         * \brief Moves the blocks into the DAG and releases the block storage. Must be called on the main thread.
+         * The version does not change, as the blocks stay the same.
+         */
+        void Archive(VoxelDag& dag);
+
+        /**
+         * \brief Expands the blocks from the DAG back into a block storage. Must be called on the main thread.
+         */
+        void Restore(VoxelDag& dag);
+
+        /**
+         * \brief Hands the archived blocks to the caller, which becomes responsible for releasing them. The section
+         * has no blocks afterwards.
+         */
+        [[nodiscard]] VoxelDag::NodeRef TakeArchive() noexcept;
+
+        /**
+         * \brief Removes the mesh and collider and destroys the actor of this section. Must be called on the main
+         * thread while no job is pending.
+         */
+        void Destroy();
+
+        /**
+         * \brief Whether a mesh or collider job of this section has not been applied on the main thread yet. The
+         * jobs refer to the section, so it must not be destroyed in the meantime.
+         */
+        [[nodiscard]] bool HasPendingJobs() const noexcept;
+
+        [[nodiscard]] uint8_t GetBlockId(int flatIndex) const noexcept;
+
+        /**
+         * \brief Whether this section only contains air. Empty sections do not allocate any block storage
+         * and are neither rendered nor meshed.
+         */
+        [[nodiscard]] bool IsEmpty() const noexcept;
+
+        /**
+         * \brief Whether every block of this section is opaque.
+         */
+        [[nodiscard]] bool IsFull() const noexcept;
+
+        [[nodiscard]] size_t GetMemoryUsage() const noexcept;
+
+        void CopyBlocks(std::span<uint8_t> destination) const noexcept;
+
     private:
         inline static std::shared_ptr<BlocksEngine::Texture2D> terrainTexture_;
 
         const Chunk& chunk_;
         const int section_;
-        std::shared_ptr<BlocksEngine::Renderer> renderer_;
 
-        [[nodiscard]] const Block& GetBlock(BlocksEngine::Vector3<int> position) const noexcept;
+        // Only created once the section has a mesh, the translucent renderer once it has see-through blocks
+        std::shared_ptr<BlocksEngine::Renderer> renderer_{nullptr};
+        std::shared_ptr<BlocksEngine::Renderer> translucentRenderer_{nullptr};
+        std::shared_ptr<BlocksEngine::Collider> collider_{nullptr};
+
+        // The current meshes and their quads, kept to patch the meshes after single block edits. Nullptr without a
+        // mesh. The opaque and the translucent mesh draw different ranges of the same vertex buffer.
+        std::shared_ptr<BlocksEngine::Mesh> mesh_{nullptr};
+        std::shared_ptr<BlocksEngine::Mesh> translucentMesh_{nullptr};
+        std::shared_ptr<BlocksEngine::VertexBuffer> vertexBuffer_{nullptr};
+        SectionQuads<Geometry> quads_{};
+
+        // The cache entry of the current meshes while they are shared with other sections, nullptr once patched
+        std::shared_ptr<const MeshCache<Geometry>::Entry> cacheEntry_{nullptr};
+
+        // The version of the blocks the current mesh shows and the request that generated it
+        uint64_t meshVersion_{0};
+        uint64_t appliedMeshRequest_{0};
+
+        // Incremented for every collider rebuilt after a patch, only the latest one is applied
+        uint64_t colliderRequest_{0};
+
+        std::atomic<std::shared_ptr<const Snapshot>> snapshot_;
+
+        // The blocks of this section while it is archived and the DAG they are stored in
+        VoxelDag::NodeRef archive_{VoxelDag::UniformFlag};
+        const VoxelDag* dag_{nullptr};
+
+        // Incremented for every mesh job, only the result of the latest job is applied
+        uint64_t meshRequest_{0};
+
+        // The bytes of the blocks and the collider and the vertex buffer last reported to the world
+        size_t memoryUsage_{0};
+        const BlocksEngine::VertexBuffer* countedBuffer_{nullptr};
+
+        // The mesh and collider jobs that have not reached the main thread yet, applied or not
+        uint32_t pendingJobs_{0};
+
+        void Publish(std::shared_ptr<const BlockStorage> blocks, const SectionOccupancy& occupancy) noexcept;
+        [[nodiscard]] size_t GetColliderMemoryUsage() const noexcept;
+
+        /**
+         * \brief Reports the changes to the blocks, the collider and the vertex buffer of this section since the last
+         * call to the residency budget of the world. Must be called on the main thread after every such change.
+         */
+        void UpdateMemoryUsage();
+        [[nodiscard]] bool IsMeshStale(uint64_t version, uint64_t meshRequest) const noexcept;
+
+        /**
+         * \brief Decomposes the current blocks into collider boxes in the background and swaps them in afterwards.
+         */
+        void RebuildCollider();
+
+        /**
+         * \brief Covers the solid blocks of a section with the boxes of its collider, see BoxDecomposition.
+         * \param getBlock Returns the block id at a position in the section.
+         */
+        template <class GetBlock>
+        [[nodiscard]] static std::vector<BlocksEngine::Collider::Box> GetColliderBoxes(const GetBlock& getBlock);
+
+        /**
+         * \brief Hands the current meshes to the renderers, creating them if needed.
+         */
+        void ShowMeshes();
+
+        [[nodiscard]] std::shared_ptr<BlocksEngine::Renderer> AddRenderer(bool translucent);
+
+        /**
+         * \brief One range of the shared quad index buffer per face id of either the opaque or the see-through
+         * quads, culled by the renderer when the camera lies behind the planes of all quads of the range.
+         */
+        [[nodiscard]] static std::vector<BlocksEngine::SubMesh> GetSubMeshes(const SectionQuads<Geometry>& quads,
+                                                                             bool translucent);
     };
 
 
@@ -118,15 +336,47 @@ public:
     // Type definitions
     //------------------------------------------------------------------------------
 
-    using ChunkCoords = BlocksEngine::Vector2<int>;
+    /**
+     * \brief The 3D coordinates of a chunk in chunks. Chunks are stacked on top of each other without a bound.
+     */
+    using ChunkCoords = BlocksEngine::Vector3<int>;
+
+    /**
+     * \brief The 3D coordinates of a section in sections: the chunk coordinates on X and Z and the world section index
+     * on Y.
+     */
+    using SectionCoords = BlocksEngine::Vector3<int>;
     using ChunkData = std::vector<uint8_t>;
+    using SectionData = std::array<std::unique_ptr<BlockStorage>, SectionsPerChunk>;
+    using SectionVolume = PaddedVolume<Geometry>;
+    using SectionMesher = Mesher<Geometry>;
+    using SectionLevelOfDetail = LevelOfDetail<Geometry>;
+    using SectionMask = std::bitset<SectionsPerChunk>;
+
+    /**
+     * \brief The roots of the archived blocks of every section in the voxel DAG.
+     */
+    using ArchiveRoots = std::array<VoxelDag::NodeRef, SectionsPerChunk>;
+
+    /**
+     * \brief Modifies a row of consecutive blocks along the X axis.
+     * Receives the block ids of the row and the world position of its first block.
+     * Returns whether any block of the row changed.
+     */
+    using RowEdit = std::function<bool(std::span<uint8_t> row, BlocksEngine::Vector3<int> start)>;
+
+    /**
+     * \brief The snapshots of a section and the 26 sections around it, indexed by GetNeighbourhoodIndex.
+     * Sections that do not exist are nullptr.
+     */
+    using SectionNeighbourhood = std::array<std::shared_ptr<const ChunkSection::Snapshot>, 27>;
 
 
     //------------------------------------------------------------------------------
     // Constructor
     //------------------------------------------------------------------------------
 
-    Chunk(const World& world, ChunkCoords coords = ChunkCoords::Zero);
+    Chunk(World& world, ChunkCoords coords = ChunkCoords::Zero);
 
     //------------------------------------------------------------------------------
     // Methods
@@ -145,19 +395,283 @@ public:
     [[nodiscard]] const Block& GetLocalBlock(BlocksEngine::Vector3<int> position) const noexcept;
     [[nodiscard]] const World& GetWorld() const noexcept;
     [[nodiscard]] ChunkCoords GetCoords() const noexcept;
+    /**
+     * \brief Whether the blocks of this chunk have been generated and are not archived.
+     */
     [[nodiscard]] bool IsInitialized() const noexcept;
 
-    void SetBlocks(ChunkData blocks);
-    [[nodiscard]] std::unique_ptr<BlocksEngine::DispatchWorkGroup> RegenerateMesh() const;
+    [[nodiscard]] bool IsArchived() const noexcept;
 
-    [[nodiscard]] static int GetFlatIndex(BlocksEngine::Vector3<int> position);
-    [[nodiscard]] static int GetFlatIndex(int x, int y, int z);
+    /**
+     * \brief Moves the blocks of every section into the DAG to save memory while the chunk is inactive.
+     * An archived chunk can not be edited or meshed until it is restored. Must be called on the main thread.
+     */
+    void Archive(VoxelDag& dag);
+
+    /**
+     * \brief Expands the blocks of an archived chunk back into block storages. Must be called on the main thread.
+     * Sections whose mesh requests were deferred while the chunk was archived are marked dirty.
+     * \return True if deferred sections were marked dirty and no other section was dirty before.
+     */
+    bool Restore(VoxelDag& dag);
+
+    /**
+     * \brief Whether any block was changed since the blocks of this chunk were generated. Modified chunks can not be
+     * generated again, so their blocks have to be kept when they are evicted.
+     */
+    [[nodiscard]] bool IsModified() const noexcept;
+
+    /**
+     * \brief Removes the meshes and colliders of an archived chunk to save memory. The sections are remeshed once
+     * the chunk is restored. Must be called on the main thread.
+     */
+    void ReleaseMeshes();
+
+    /**
+     * \brief Hands the archived blocks of every section to the caller, which becomes responsible for releasing them.
+     * Used to evict an archived chunk, which can neither be restored nor edited afterwards.
+     */
+    [[nodiscard]] ArchiveRoots TakeArchive() noexcept;
+
+    /**
+     * \brief Destroys the actors of this chunk and its sections along with their meshes and colliders. The chunk must
+     * be unlinked from its neighbours and have no pending jobs. Must be called on the main thread.
+     */
+    void Destroy();
+
+    /**
+     * \brief Whether a mesh or collider job of any section has not been applied on the main thread yet.
+     */
+    [[nodiscard]] bool HasPendingJobs() const noexcept;
+
+    /**
+     * \brief The height above the highest non air block of a column. Maintained on every write.
+     * \param x The x coordinate of the column in the chunk.
+     * \param z The z coordinate of the column in the chunk.
+     * \return The y coordinate in the chunk of the first block above the surface, 0 if the column only contains air.
+     */
+    [[nodiscard]] int GetSurfaceHeight(int x, int z) const noexcept;
+
+    /**
+     * \brief The number of bytes used to store the blocks of this chunk.
+     */
+    [[nodiscard]] size_t GetMemoryUsage() const noexcept;
+
+    /**
+     * \brief Assigns the blocks of every section. Must be called on the main thread.
+     * \param blocks The blocks of the chunk indexed by GetFlatIndex.
+     * \param isModified Whether the blocks differ from the generated ones, e.g. the archived blocks of an evicted
+     * chunk that was edited.
+     */
+    void SetBlocks(const ChunkData& blocks, bool isModified = false);
+
+    /**
+     * \brief Replaces a single block. Must be called on the main thread.
+     * \param position The position of the block in the chunk.
+     * \param blockId The new id of the block.
+     * \return False if the block already had the given id.
+     */
+    bool SetLocalBlock(BlocksEngine::Vector3<int> position, uint8_t blockId);
+
+    /**
+     * \brief Edits a box of blocks inside a single section in one pass. Must be called on the main thread.
+     * The section is decoded once, every row of the box is passed to the edit and the result is published as
+     * a single new version.
+     * \param section The index of the section.
+     * \param min The inclusive lower corner of the box in section coordinates.
+     * \param max The inclusive upper corner of the box in section coordinates.
+     * \param edit The edit applied to every row of the box.
+     * \return Whether any block changed.
+     */
+    bool EditSection(int section, BlocksEngine::Vector3<int> min, BlocksEngine::Vector3<int> max,
+                     const RowEdit& edit);
+
+    /**
+     * \brief Decodes the blocks of a section into a flat array indexed by GetSectionFlatIndex.
+     * \param section The index of the section to decode.
+     * \param destination The array to write to. Must be at least SectionSize long.
+     */
+    void CopySectionBlocks(int section, std::span<uint8_t> destination) const noexcept;
+
+    /**
+     * \brief Links an adjacent chunk, including the ones touching only an edge or a corner. Must be called on the main
+     * thread.
+     * \param dx The offset of the neighbour on the X axis in chunks, between -1 and 1.
+     * \param dy The offset of the neighbour on the Y axis in chunks, between -1 and 1.
+     * \param dz The offset of the neighbour on the Z axis in chunks, between -1 and 1.
+     * \param neighbour The adjacent chunk or nullptr to unlink it.
+     */
+    void SetNeighbour(int dx, int dy, int dz, Chunk* neighbour) noexcept;
+
+    /**
+     * \brief The linked chunk at the given offset, this chunk for an offset of zero.
+     * \return The adjacent chunk or nullptr if it does not exist.
+     */
+    [[nodiscard]] const Chunk* GetNeighbour(int dx, int dy, int dz) const noexcept;
+
+    /**
+     * \brief Takes the snapshots of a section and of the sections around it, including the ones of the linked neighbours
+     * above and below. Must be called on the main thread. The returned snapshots can be read on any thread.
+     * \param section The index of the section in this chunk.
+     */
+    [[nodiscard]] SectionNeighbourhood GetSectionNeighbourhood(int section) const;
+
+    [[nodiscard]] std::unique_ptr<BlocksEngine::DispatchWorkGroup> RegenerateMesh();
+
+    [[nodiscard]] int GetLevelOfDetail() const noexcept;
+
+    /**
+     * \brief Selects the resolution every section of this chunk is meshed with, see LevelOfDetail.
+     * Sections are not marked dirty, as the neighbouring chunks have to be remeshed as well.
+     * \param level The level between 0 for the full resolution and SectionLevelOfDetail::LevelCount - 1.
+     * \return Whether the level changed.
+     */
+    bool SetLevelOfDetail(int level) noexcept;
+
+    /**
+     * \brief The levels of the neighbouring chunks along every face of a section, this chunk's level for chunks that
+     * are not loaded.
+     */
+    [[nodiscard]] SectionLevelOfDetail::BorderLevels GetBorderLevels() const noexcept;
+
+    /**
+     * \brief Patches the mesh of a section in place after a single block changed. Must be called on the main thread.
+     * \param section The index of the section.
+     * \param position The changed block relative to the section, it can also lie in the border around it.
+     * \return False if the section has to be marked dirty instead, e.g. because it is waiting to be remeshed anyway or
+     * it or a neighbour is not meshed at the full resolution.
+     */
+    bool PatchSection(int section, BlocksEngine::Vector3<int> position);
+
+    /**
+     * \brief Marks a section to be remeshed by the next call to RegenerateDirtySections.
+     * \return True if no other section of this chunk was dirty before.
+     */
+    bool MarkSectionDirty(int section) noexcept;
+
+    /**
+     * \brief Creates one mesh job per dirty section and marks all sections as clean.
+     */
+    [[nodiscard]] std::unique_ptr<BlocksEngine::DispatchWorkGroup> RegenerateDirtySections();
+
+    [[nodiscard]] static int GetFlatIndex(BlocksEngine::Vector3<int> position) noexcept;
+    [[nodiscard]] static constexpr int GetFlatIndex(int x, int y, int z) noexcept;
+    [[nodiscard]] static int GetSectionFlatIndex(BlocksEngine::Vector3<int> position) noexcept;
+
+    /**
+     * \brief Splits the blocks of a chunk into the storages of its sections.
+     * \param blocks The blocks of the chunk indexed by GetFlatIndex.
+     * \return One storage per section, nullptr for sections that only contain air.
+     */
+    [[nodiscard]] static SectionData SplitIntoSections(const ChunkData& blocks);
+
+    /**
+     * \brief Copies the blocks of a section and the one block border around it into a padded volume.
+     * \param neighbourhood The snapshots of the section and its surrounding sections.
+     * \param volume The volume to write to.
+     */
+    static void CopySectionVolume(const SectionNeighbourhood& neighbourhood, SectionVolume& volume) noexcept;
+
+    /**
+     * \brief The id of a block in a neighbourhood, air for sections that do not exist. Archived sections are read
+     * from the border of their faces towards the section in the centre.
+     * \param neighbourhood The snapshots of the section and its surrounding sections.
+     * \param x The x coordinate relative to the section, from -1 up to and including Width.
+     * \param y The y coordinate relative to the section, from -1 up to and including SectionHeight.
+     * \param z The z coordinate relative to the section, from -1 up to and including Depth.
+     */
+    [[nodiscard]] static uint8_t GetNeighbourhoodBlock(const SectionNeighbourhood& neighbourhood, int x, int y,
+                                                       int z) noexcept;
+
+    [[nodiscard]] static constexpr int GetNeighbourhoodIndex(int dx, int dy, int dz) noexcept;
+
+    /**
+     * \brief The index of a block on one of the six outer faces of a section in the border of an archived section.
+     * \return The index from 0 to BorderSize or -1 if the block lies inside of the section.
+     */
+    [[nodiscard]] static constexpr int GetBorderIndex(int x, int y, int z) noexcept;
 
 
 private:
-    std::optional<ChunkData> blocks_{std::nullopt};
-    const World& world_;
+    bool isInitialized_{false};
+    bool isArchived_{false};
+    bool isModified_{false};
+    // Not const, as the sections report their memory to the residency budget of the world
+    World& world_;
     const ChunkCoords coords_;
 
     std::vector<std::shared_ptr<ChunkSection>> sections_;
+
+    // The 3x3x3 chunks around and including this one, indexed by GetNeighbourIndex
+    std::array<Chunk*, 27> neighbours_{};
+
+    std::array<int16_t, Width * Depth> heightmap_{};
+
+    SectionMask dirtySections_{};
+
+    int levelOfDetail_{0};
+
+    // The sections whose mesh request was deferred while the chunk was archived
+    SectionMask deferredSections_{};
+
+    [[nodiscard]] std::unique_ptr<BlocksEngine::DispatchWorkGroup> RegenerateSections(SectionMask sections);
+
+    /**
+     * \brief Whether all six sections around a section are full, so none of its faces can be seen.
+     */
+    [[nodiscard]] bool IsSectionHidden(int section) const noexcept;
+
+    /**
+     * \brief The section at an offset from a section of this chunk, which can lie in a linked neighbour.
+     * \param section The index of the section in this chunk.
+     * \return The section or nullptr if its chunk is not loaded.
+     */
+    [[nodiscard]] const ChunkSection* GetNeighbourSection(int section, int dx, int dy, int dz) const noexcept;
+
+    /**
+     * \brief Searches the column masks of the sections from the top for the surface of a column.
+     */
+    [[nodiscard]] int FindSurfaceHeight(int x, int z) const noexcept;
+
+    [[nodiscard]] static constexpr int GetNeighbourIndex(int dx, int dy, int dz) noexcept;
 };
+
+inline int Blocks::Chunk::GetFlatIndex(const BlocksEngine::Vector3<int> position) noexcept
+{
+    return Geometry::GetFlatIndex(position.x, position.y, position.z);
+}
+
+constexpr int Blocks::Chunk::GetFlatIndex(const int x, const int y, const int z) noexcept
+{
+    return Geometry::GetFlatIndex(x, y, z);
+}
+
+constexpr int Blocks::Chunk::GetNeighbourIndex(const int dx, const int dy, const int dz) noexcept
+{
+    return dx + 1 + (dz + 1) * 3 + (dy + 1) * 9;
+}
+
+constexpr int Blocks::Chunk::GetNeighbourhoodIndex(const int dx, const int dy, const int dz) noexcept
+{
+    return GetNeighbourIndex(dx, dy, dz);
+}
+
+constexpr int Blocks::Chunk::GetBorderIndex(const int x, const int y, const int z) noexcept
+{
+    // The faces at the lowest and the highest x, then y and then z, each one row by row
+    int offset = 0;
+    if (x == 0 || x == Width - 1) return offset + (x != 0) * SectionHeight * Depth + y + z * SectionHeight;
+
+    offset += 2 * SectionHeight * Depth;
+    if (y == 0 || y == SectionHeight - 1) return offset + (y != 0) * Depth * Width + x + z * Width;
+
+    offset += 2 * Depth * Width;
+    if (z == 0 || z == Depth - 1) return offset + (z != 0) * Width * SectionHeight + x + y * Width;
+
+    return -1;
+}
+
+inline int Blocks::Chunk::GetSectionFlatIndex(const BlocksEngine::Vector3<int> position) noexcept
+{
+    return Geometry::GetSectionFlatIndex(position.x, position.y, position.z);
+}
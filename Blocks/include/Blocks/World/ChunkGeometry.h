@@ -0,0 +1,122 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: ChunkGeometry.h
+
+#pragma once
+
+#include "ChunkLayout.h"
+
+// The height of a chunk in blocks. Chunks are stacked on top of each other without a bound, so this only selects how
+// many sections a chunk holds. Must be a multiple of 16.
+#ifndef BLOCKS_CHUNK_HEIGHT
+#define BLOCKS_CHUNK_HEIGHT 16
+#endif
+
+// The order in which blocks are stored in memory. One of Blocks::LinearLayout, Blocks::MortonLayout
+// or Blocks::TiledLayout. Linear is the default as it was the fastest layout for both neighbour queries and greedy
+// meshing in the ChunkLayout benchmark, the meshers walk rows along x and the others pay for their index calculation.
+#ifndef BLOCKS_CHUNK_LAYOUT
+#define BLOCKS_CHUNK_LAYOUT Blocks::LinearLayout
+#endif
+
+namespace Blocks
+{
+    template <int WidthBits, int DepthBits, int SectionHeightBits, int Sections, class Layout = LinearLayout>
+    struct ChunkGeometry;
+}
+
+/**
+ * \brief Describes the dimensions of a chunk at compile time.
+ *
+ * The width, depth and section height are powers of two, so every index calculation reduces to shifts and masks.
+ * Sections are stored one after the other, so every section is a contiguous range of the chunk.
+ * Inside of a section the blocks are ordered by the layout.
+ *
+ * \tparam WidthBits Log2 of the number of blocks on the X axis.
+ * \tparam DepthBits Log2 of the number of blocks on the Z axis.
+ * \tparam SectionHeightBits Log2 of the number of blocks per section on the Y axis.
+ * \tparam Sections The number of sections stacked on top of each other.
+ * \tparam Layout The order of the blocks inside of a section. See ChunkLayout.h
+ */
+template <int WidthBits, int DepthBits, int SectionHeightBits, int Sections, class Layout>
+struct Blocks::ChunkGeometry
+{
+    static_assert(Sections > 0, "A chunk needs at least one section");
+
+    using BlockLayout = Layout;
+
+    static constexpr int Width = 1 << WidthBits;
+    static constexpr int Depth = 1 << DepthBits;
+    static constexpr int SectionHeight = 1 << SectionHeightBits;
+    static constexpr int SectionsPerChunk = Sections;
+    static constexpr int Height = SectionHeight * SectionsPerChunk;
+    static constexpr int SectionSize = Width * Depth * SectionHeight;
+    static constexpr int Size = SectionSize * SectionsPerChunk;
+
+    /**
+     * \brief The index of a block inside the chunk. X and Z are wrapped into the chunk, Y must lie inside of it.
+     */
+    [[nodiscard]] static constexpr int GetFlatIndex(const int x, const int y, const int z) noexcept
+    {
+        return GetSection(y) * SectionSize + GetSectionFlatIndex(x, y, z);
+    }
+
+    /**
+     * \brief The index of a block inside its section. All coordinates are wrapped into the section.
+     */
+    [[nodiscard]] static constexpr int GetSectionFlatIndex(const int x, const int y, const int z) noexcept
+    {
+        return Layout::template Index<WidthBits, DepthBits, SectionHeightBits>(
+            x & (Width - 1), y & (SectionHeight - 1), z & (Depth - 1));
+    }
+
+    /**
+     * \brief The section containing the given y coordinate.
+     */
+    [[nodiscard]] static constexpr int GetSection(const int y) noexcept
+    {
+        return y >> SectionHeightBits;
+    }
+
+    /**
+     * \brief The chunk coordinate on the X axis containing the given world coordinate, rounded towards negative infinity.
+     */
+    [[nodiscard]] static constexpr int GetChunkX(const int x) noexcept
+    {
+        return x >> WidthBits;
+    }
+
+    /**
+     * \brief The chunk coordinate on the Z axis containing the given world coordinate, rounded towards negative infinity.
+     */
+    [[nodiscard]] static constexpr int GetChunkZ(const int z) noexcept
+    {
+        return z >> DepthBits;
+    }
+
+    /**
+     * \brief The chunk coordinate on the Y axis containing the given world coordinate, rounded towards negative infinity.
+     * The height is not necessarily a power of two.
+     */
+    [[nodiscard]] static constexpr int GetChunkY(const int y) noexcept
+    {
+        return y >= 0 ? y / Height : -((-y - 1) / Height) - 1;
+    }
+};
+
+namespace Blocks
+{
+    static_assert(BLOCKS_CHUNK_HEIGHT > 0 && BLOCKS_CHUNK_HEIGHT % 16 == 0,
+        "The chunk height must be a positive multiple of 16");
+
+    /**
+     * \brief The geometry used by the game: 16x16 blocks wide, split into sections of 16 blocks height. By default a
+     * chunk is a single cubic section.
+     */
+    using DefaultChunkGeometry = ChunkGeometry<4, 4, 4, BLOCKS_CHUNK_HEIGHT / 16, BLOCKS_CHUNK_LAYOUT>;
+}
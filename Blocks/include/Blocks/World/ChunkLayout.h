@@ -0,0 +1,89 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: ChunkLayout.h
+
+#pragma once
+
+#include <cstdint>
+
+// A chunk layout decides in which order the blocks of a section are stored in memory.
+// Every layout provides a static constexpr Index function which maps coordinates, that are already wrapped
+// into the section, to an index in [0, section size).
+
+namespace Blocks
+{
+    struct LinearLayout;
+    struct MortonLayout;
+    struct TiledLayout;
+}
+
+/**
+ * \brief Stores the blocks row by row with x varying fastest, then z and then y.
+ */
+struct Blocks::LinearLayout
+{
+    template <int WidthBits, int DepthBits, int HeightBits>
+    [[nodiscard]] static constexpr int Index(const int x, const int y, const int z) noexcept
+    {
+        return x | z << WidthBits | y << (WidthBits + DepthBits);
+    }
+};
+
+/**
+ * \brief Stores the blocks along a Z-order curve by interleaving the bits of the coordinates.
+ * Blocks that are close to each other on any axis are likely to be close in memory as well.
+ */
+struct Blocks::MortonLayout
+{
+    template <int WidthBits, int DepthBits, int HeightBits>
+    [[nodiscard]] static constexpr int Index(const int x, const int y, const int z) noexcept
+    {
+        static_assert(WidthBits == DepthBits && DepthBits == HeightBits, "Morton layouts require cubic sections");
+        static_assert(WidthBits <= 10, "Morton layouts support at most 1024 blocks per axis");
+
+        return static_cast<int>(SpreadBits(x) | SpreadBits(z) << 1 | SpreadBits(y) << 2);
+    }
+
+private:
+    /**
+     * \brief Inserts two zero bits between each of the lower 10 bits of the value.
+     */
+    [[nodiscard]] static constexpr uint32_t SpreadBits(const int value) noexcept
+    {
+        auto v = static_cast<uint32_t>(value) & 0x3ffu;
+        v = (v | v << 16) & 0x030000ffu;
+        v = (v | v << 8) & 0x0300f00fu;
+        v = (v | v << 4) & 0x030c30c3u;
+        v = (v | v << 2) & 0x09249249u;
+        return v;
+    }
+};
+
+/**
+ * \brief Stores the blocks in bricks of 4x4x4 blocks. The bricks themselves are ordered linearly.
+ */
+struct Blocks::TiledLayout
+{
+    static constexpr int BrickBits = 2;
+
+    template <int WidthBits, int DepthBits, int HeightBits>
+    [[nodiscard]] static constexpr int Index(const int x, const int y, const int z) noexcept
+    {
+        static_assert(WidthBits >= BrickBits && DepthBits >= BrickBits && HeightBits >= BrickBits,
+            "Tiled layouts require sections of at least 4 blocks on every axis");
+
+        constexpr int brickMask = (1 << BrickBits) - 1;
+
+        const int inBrick = (x & brickMask) | (z & brickMask) << BrickBits | (y & brickMask) << 2 * BrickBits;
+        const int brick = (x >> BrickBits)
+            | (z >> BrickBits) << (WidthBits - BrickBits)
+            | (y >> BrickBits) << (WidthBits - BrickBits + DepthBits - BrickBits);
+
+        return brick << 3 * BrickBits | inBrick;
+    }
+};
@@ -0,0 +1,567 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: BinaryMesher.h
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <emmintrin.h>
+
+#include "Blocks/World/Meshing/ChunkMeshData.h"
+#include "Blocks/World/Meshing/Mesher.h"
+#include "Blocks/World/Meshing/PaddedVolume.h"
+
+namespace Blocks
+{
+    template <class Geometry>
+    class BinaryMesher;
+}
+
+/**
+ * \brief A greedy mesher working on bitmasks, generating exactly the same quads as the GreedyMesher.
+ *
+ * The solid blocks of every row along the x axis are stored as one bitmask, so the visible faces of a whole row are
+ * found with a few bitwise operations on two neighbouring rows. Faces pointing along x and y are then transposed into
+ * the rows the greedy mesher merges along, 16 by 16 bits at a time with SSE2, so only the faces are ever transposed
+ * and not the blocks. The faces are merged greedily with bit scans, block ids are only read for the faces that exist
+ * instead of twice for every block.
+ * See-through blocks other than air get masks of their own, only their neighbours are compared block by block.
+ *
+ * \tparam Geometry The ChunkGeometry of the section to mesh.
+ */
+template <class Geometry>
+class Blocks::BinaryMesher final : public Mesher<Geometry>
+{
+public:
+    [[nodiscard]] std::string_view GetName() const noexcept override;
+
+protected:
+    void FindQuads(const PaddedVolume<Geometry>& volume, MeshScratch<Geometry>& scratch) const override;
+
+private:
+    using Volume = PaddedVolume<Geometry>;
+
+    // The number of blocks along every axis of a section, one bit per block fits a row into 16 bits
+    static constexpr int Size = 16;
+
+    static_assert(Geometry::Width == Size && Geometry::SectionHeight == Size && Geometry::Depth == Size,
+        "The masks of the binary mesher hold the 16 blocks of a row of a section");
+
+    // Bit x + 1 of rows[a + 1][b + 1] is set for the block at x, all coordinates starting at -1. The solid rows are
+    // kept by y and z and once more by z and y, so the rows compared by a slice always lie next to each other.
+    using Rows = std::array<std::array<uint32_t, Volume::Depth>, Volume::Height>;
+
+    // The faces of the 16 rows of a slice before they are transposed or narrowed into planes
+    using FaceRows = std::array<uint32_t, Size>;
+
+    // Bit i of planes[slice * Size + j] is set if the slice has a face at (i, j), like the masks of the greedy mesher
+    using Planes = std::array<uint16_t, (Size + 1) * Size>;
+
+    // Bit i of same[j] is set if the block of the face at (i, j) equals a neighbouring block of the slice
+    using SameMask = std::array<uint16_t, Size>;
+
+    // The faces between two rows of blocks, backFaces belong to the blocks after and point towards the negative axis
+    struct RowFaces
+    {
+        uint32_t faces;
+        uint32_t backFaces;
+    };
+
+    /**
+     * \brief Converts the block ids of the volume into the rows of solid blocks.
+     * Sixteen blocks are compared to air at once, a row of 18 blocks therefore takes two overlapping comparisons.
+     * \param rows The rows by y and z.
+     * \param rowsByZ The same rows by z and y.
+     */
+    static void BuildRows(const Volume& volume, Rows& rows, Rows& rowsByZ) noexcept;
+
+    /**
+     * \brief Converts the see-through blocks of the volume apart from air into rows by y and z.
+     * Built block by block, but only if any see-through block is registered.
+     * \return False if the volume contains no such block, the rows are then left uninitialized.
+     */
+    static bool BuildTranslucentRows(const Volume& volume, const BlockRegistry::SeeThroughTable& seeThrough,
+                                     Rows& rows) noexcept;
+
+    /**
+     * \brief Finds and merges the faces of all three axes.
+     * \tparam HasTranslucent Whether the section contains see-through blocks other than air, the rows of those are
+     * only read if it does.
+     */
+    template <bool HasTranslucent>
+    static void FindQuads(const Volume& volume, const Rows& solid, const Rows& solidByZ, const Rows& translucent,
+                          MeshScratch<Geometry>& scratch);
+
+    /**
+     * \brief Finds the faces between 16 pairs of rows of solid blocks and air, four pairs at a time with SSE2.
+     * \param afterShift The rows after are shifted right by this many bits before they are compared.
+     * \param facesShift The faces are shifted right by this many bits and masked afterwards.
+     */
+    static void FindSolidFaces(const uint32_t* before, const uint32_t* after, int afterShift, int facesShift,
+                               uint32_t mask, FaceRows& faces, FaceRows& backFaces) noexcept;
+
+    /**
+     * \brief Finds the faces between two rows of blocks next to see-through blocks other than air, bit i of the rows
+     * being the pair of blocks compared. Neighbouring see-through blocks are compared block by block.
+     * \param afterIndex The index in the volume of the block after of bit 0, the block of bit i follows along x.
+     * \param strideDim The distance in the volume from the block after to the block before.
+     */
+    static RowFaces FindFaces(const Volume& volume, uint32_t solidBefore, uint32_t solidAfter,
+                              uint32_t translucentBefore, uint32_t translucentAfter, int afterIndex,
+                              int strideDim) noexcept;
+
+    /**
+     * \brief Transposes 16 rows of Columns bits, bit i of rows[j] becomes bit j of columns[i * stride].
+     * \tparam Columns At most 24, the number of columns written.
+     */
+    template <int Columns>
+    static void Transpose(const std::array<uint32_t, Size>& rows, uint16_t* columns, int stride) noexcept;
+
+    /**
+     * \brief Compares the blocks of the faces of a slice to the blocks before them along u and v.
+     * Bit i of sameU[j] is set if the block at (i, j) is the same as the one at (i - 1, j), of sameV[j] if it is the
+     * same as the one at (i, j - 1). Slices along y and z compare whole rows of blocks with SSE2, slices along x only
+     * compare the blocks of the rows with faces.
+     * \param blockIndex The index in the volume of the block at (0, 0).
+     * \param rows Bit j is set for the rows of the slice holding any face.
+     */
+    static void CompareBlocks(const Volume& volume, const uint16_t* faces, uint32_t rows, int dim, int blockIndex,
+                              SameMask& sameU, SameMask& sameV) noexcept;
+
+    /**
+     * \brief Merges the faces of one side of a slice in the same order as the greedy mesher and collects the quads.
+     * \param faces The Size rows of the slice, cleared while merging.
+     * \param back True for the faces pointing towards the negative axis.
+     */
+    static void MergeFaces(const Volume& volume, uint16_t* faces, int dim, int slice, bool back,
+                           MeshScratch<Geometry>& scratch);
+};
+
+template <class Geometry>
+void Blocks::BinaryMesher<Geometry>::FindQuads(const PaddedVolume<Geometry>& volume,
+                                                MeshScratch<Geometry>& scratch) const
+{
+    Rows solid;
+    Rows solidByZ;
+    BuildRows(volume, solid, solidByZ);
+
+    // The same for the solid blocks that are see-through, which only exist in some sections
+    const BlockRegistry::SeeThroughTable& seeThrough = BlockRegistry::GetSeeThroughTable();
+    Rows translucent;
+    if (BuildTranslucentRows(volume, seeThrough, translucent))
+    {
+        FindQuads<true>(volume, solid, solidByZ, translucent, scratch);
+    }
+    else
+    {
+        FindQuads<false>(volume, solid, solidByZ, translucent, scratch);
+    }
+}
+
+template <class Geometry>
+template <bool HasTranslucent>
+void Blocks::BinaryMesher<Geometry>::FindQuads(const Volume& volume, const Rows& solid, const Rows& solidByZ,
+                                                const Rows& translucent, MeshScratch<Geometry>& scratch)
+{
+    constexpr int strideX = Volume::GetIndex(1, 0, 0) - Volume::GetIndex(0, 0, 0);
+    constexpr int strideY = Volume::GetIndex(0, 1, 0) - Volume::GetIndex(0, 0, 0);
+    constexpr int strideZ = Volume::GetIndex(0, 0, 1) - Volume::GetIndex(0, 0, 0);
+    constexpr uint32_t interior = (uint32_t{1} << Size) - 1;
+
+    Planes faces;
+    Planes backFaces;
+    FaceRows faceRows;
+    FaceRows backFaceRows;
+
+    // Rows next to see-through blocks other than air are found again block by block, given by padded coordinates
+    const auto findTranslucentFaces = [&](const int row, const int y, const int z, const int yAfter,
+                                          const int zAfter, const int strideDim)
+    {
+        if (!translucent[y][z] && !translucent[yAfter][zAfter]) return;
+
+        const RowFaces rowFaces = FindFaces(volume, solid[y][z] >> 1 & interior, solid[yAfter][zAfter] >> 1 & interior,
+                                            translucent[y][z] >> 1 & interior,
+                                            translucent[yAfter][zAfter] >> 1 & interior,
+                                            Volume::GetIndex(0, yAfter - 1, zAfter - 1), strideDim);
+        faceRows[row] = rowFaces.faces;
+        backFaceRows[row] = rowFaces.backFaces;
+    };
+
+    // Merges every slice along dim, slice s holds the faces between the blocks at s - 1 and s like in the greedy mesher
+    const auto mergeSlices = [&](const int dim)
+    {
+        for (int slice = 0; slice <= Size; ++slice)
+        {
+            MergeFaces(volume, &faces[slice * Size], dim, slice, false, scratch);
+            MergeFaces(volume, &backFaces[slice * Size], dim, slice, true, scratch);
+        }
+    };
+
+    // Faces pointing along x. Bit s of a row compares the blocks at x = s - 1 and s, so a row holds all 17 slices at
+    // once and the rows of a layer of constant z become the rows over y of every slice.
+    for (int z = 0; z < Size; ++z)
+    {
+        const uint32_t* rows = &solidByZ[z + 1][1];
+        FindSolidFaces(rows, rows, 1, 0, (uint32_t{1} << (Size + 1)) - 1, faceRows, backFaceRows);
+
+        if constexpr (HasTranslucent)
+        {
+            for (int y = 0; y < Size; ++y)
+            {
+                const uint32_t row = solid[y + 1][z + 1];
+                const uint32_t translucentRow = translucent[y + 1][z + 1];
+                if (!translucentRow) continue;
+
+                const RowFaces rowFaces = FindFaces(volume, row, row >> 1, translucentRow, translucentRow >> 1,
+                                                    Volume::GetIndex(0, y, z), strideX);
+                faceRows[y] = rowFaces.faces;
+                backFaceRows[y] = rowFaces.backFaces;
+            }
+        }
+
+        Transpose<Size + 1>(faceRows, &faces[z], Size);
+        Transpose<Size + 1>(backFaceRows, &backFaces[z], Size);
+    }
+    mergeSlices(0);
+
+    // Faces pointing along y, the rows over x of every slice are transposed into rows over z
+    for (int slice = 0; slice <= Size; ++slice)
+    {
+        FindSolidFaces(&solid[slice][1], &solid[slice + 1][1], 0, 1, interior, faceRows, backFaceRows);
+        if constexpr (HasTranslucent)
+        {
+            for (int z = 0; z < Size; ++z)
+            {
+                findTranslucentFaces(z, slice, z + 1, slice + 1, z + 1, strideY);
+            }
+        }
+
+        Transpose<Size>(faceRows, &faces[slice * Size], 1);
+        Transpose<Size>(backFaceRows, &backFaces[slice * Size], 1);
+    }
+    mergeSlices(1);
+
+    // Faces pointing along z already are rows over x
+    for (int slice = 0; slice <= Size; ++slice)
+    {
+        FindSolidFaces(&solidByZ[slice][1], &solidByZ[slice + 1][1], 0, 1, interior, faceRows, backFaceRows);
+        if constexpr (HasTranslucent)
+        {
+            for (int y = 0; y < Size; ++y)
+            {
+                findTranslucentFaces(y, y + 1, slice, y + 1, slice + 1, strideZ);
+            }
+        }
+
+        std::copy(faceRows.begin(), faceRows.end(), &faces[slice * Size]);
+        std::copy(backFaceRows.begin(), backFaceRows.end(), &backFaces[slice * Size]);
+    }
+    mergeSlices(2);
+}
+
+template <class Geometry>
+std::string_view Blocks::BinaryMesher<Geometry>::GetName() const noexcept
+{
+    return "binary";
+}
+
+template <class Geometry>
+void Blocks::BinaryMesher<Geometry>::BuildRows(const Volume& volume, Rows& rows, Rows& rowsByZ) noexcept
+{
+    const __m128i air = _mm_setzero_si128();
+
+    for (int y = 0; y < Volume::Height; ++y)
+    {
+        for (int z = 0; z < Volume::Depth; ++z)
+        {
+            const uint8_t* row = volume.GetRow(y - 1, z - 1).data();
+
+            // The bits of the first 16 blocks and of the last 16, which overlap apart from the first and last two
+            const auto first = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row)), air)));
+            const auto last = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 2)), air)));
+
+            rows[y][z] = rowsByZ[z][y] = ~(first | last << 2) & ((uint32_t{1} << Volume::Width) - 1);
+        }
+    }
+}
+
+template <class Geometry>
+bool Blocks::BinaryMesher<Geometry>::BuildTranslucentRows(const Volume& volume,
+                                                           const BlockRegistry::SeeThroughTable& seeThrough,
+                                                           Rows& rows) noexcept
+{
+    if (std::none_of(seeThrough.begin() + 1, seeThrough.end(), [](const bool value) { return value; })) return false;
+
+    bool found = false;
+    for (int y = 0; y < Volume::Height; ++y)
+    {
+        for (int z = 0; z < Volume::Depth; ++z)
+        {
+            const std::span<const uint8_t, Volume::Width> row = volume.GetRow(y - 1, z - 1);
+
+            uint32_t translucentRow = 0;
+            for (int x = 0; x < Volume::Width; ++x)
+            {
+                if (row[x] && seeThrough[row[x]])
+                {
+                    translucentRow |= uint32_t{1} << x;
+                }
+            }
+
+            rows[y][z] = translucentRow;
+            found |= translucentRow != 0;
+        }
+    }
+
+    return found;
+}
+
+template <class Geometry>
+void Blocks::BinaryMesher<Geometry>::FindSolidFaces(const uint32_t* before, const uint32_t* after,
+                                                     const int afterShift, const int facesShift, const uint32_t mask,
+                                                     FaceRows& faces, FaceRows& backFaces) noexcept
+{
+    const __m128i afterCount = _mm_cvtsi32_si128(afterShift);
+    const __m128i facesCount = _mm_cvtsi32_si128(facesShift);
+    const __m128i faceMask = _mm_set1_epi32(static_cast<int>(mask));
+
+    for (int i = 0; i < Size; i += 4)
+    {
+        const __m128i rowBefore = _mm_loadu_si128(reinterpret_cast<const __m128i*>(before + i));
+        const __m128i rowAfter = _mm_srl_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(after + i)),
+                                               afterCount);
+
+        // A face exists wherever a solid block is followed by air or the other way around
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&faces[i]),
+                         _mm_and_si128(_mm_srl_epi32(_mm_andnot_si128(rowAfter, rowBefore), facesCount), faceMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&backFaces[i]),
+                         _mm_and_si128(_mm_srl_epi32(_mm_andnot_si128(rowBefore, rowAfter), facesCount), faceMask));
+    }
+}
+
+template <class Geometry>
+typename Blocks::BinaryMesher<Geometry>::RowFaces Blocks::BinaryMesher<Geometry>::FindFaces(
+    const Volume& volume, const uint32_t solidBefore, const uint32_t solidAfter, const uint32_t translucentBefore,
+    const uint32_t translucentAfter, const int afterIndex, const int strideDim) noexcept
+{
+    constexpr int strideX = Volume::GetIndex(1, 0, 0) - Volume::GetIndex(0, 0, 0);
+
+    // Two see-through blocks only hide each other's faces if they are the same block
+    uint32_t sameKind = 0;
+    uint32_t candidates = translucentBefore & translucentAfter;
+    while (candidates)
+    {
+        const int i = std::countr_zero(candidates);
+        candidates &= candidates - 1;
+
+        const int index = afterIndex + i * strideX;
+        if (volume.Get(index) == volume.Get(index - strideDim))
+        {
+            sameKind |= uint32_t{1} << i;
+        }
+    }
+
+    // A face exists wherever a solid block is followed by a see-through one or the other way around
+    return {
+        solidBefore & (~solidAfter | translucentAfter) & ~sameKind,
+        solidAfter & (~solidBefore | translucentBefore) & ~sameKind
+    };
+}
+
+template <class Geometry>
+template <int Columns>
+void Blocks::BinaryMesher<Geometry>::Transpose(const std::array<uint32_t, Size>& rows, uint16_t* columns,
+                                                const int stride) noexcept
+{
+    static_assert(Columns <= 24, "Only the lowest three bytes of the rows are transposed");
+
+    // Byte b of the rows is gathered into one vector holding the byte of every row, the highest bit of every byte is
+    // then collected with movemask. Adding a vector to itself shifts the next bit up.
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    __m128i words[4];
+    __m128i any = _mm_setzero_si128();
+    for (int i = 0; i < 4; ++i)
+    {
+        words[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&rows[i * 4]));
+        any = _mm_or_si128(any, words[i]);
+    }
+
+    // Sections are mostly solid or empty, a layer without faces skips the transpose
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(any, _mm_setzero_si128())) == 0xFFFF)
+    {
+        for (int i = 0; i < Columns; ++i)
+        {
+            columns[i * stride] = 0;
+        }
+        return;
+    }
+
+    for (int byte = 0; byte * 8 < Columns; ++byte)
+    {
+        __m128i bytes[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            bytes[i] = _mm_and_si128(_mm_srli_epi32(words[i], byte * 8), byteMask);
+        }
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(bytes[0], bytes[1]), _mm_packs_epi32(bytes[2], bytes[3]));
+
+        for (int bit = 7; bit >= 0; --bit)
+        {
+            if (const int column = byte * 8 + bit; column < Columns)
+            {
+                columns[column * stride] = static_cast<uint16_t>(_mm_movemask_epi8(packed));
+            }
+            packed = _mm_add_epi8(packed, packed);
+        }
+    }
+}
+
+template <class Geometry>
+void Blocks::BinaryMesher<Geometry>::CompareBlocks(const Volume& volume, const uint16_t* faces, const uint32_t rows,
+                                                    const int dim, const int blockIndex, SameMask& sameU,
+                                                    SameMask& sameV) noexcept
+{
+    constexpr int strides[3] = {
+        Volume::GetIndex(1, 0, 0) - Volume::GetIndex(0, 0, 0),
+        Volume::GetIndex(0, 1, 0) - Volume::GetIndex(0, 0, 0),
+        Volume::GetIndex(0, 0, 1) - Volume::GetIndex(0, 0, 0)
+    };
+
+    const int strideU = strides[(dim + 1) % 3];
+    const int strideV = strides[(dim + 2) % 3];
+
+    // Bit x is set if the blocks x along the rows starting at a and b are the same
+    const auto compareRows = [&volume](const int a, const int b)
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(volume.GetData(a))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(volume.GetData(b))))));
+    };
+
+    if (dim == 2)
+    {
+        // The rows of a slice along z run along x, as do the rows of blocks
+        for (int j = 0; j < Size; ++j)
+        {
+            const int index = blockIndex + j * strideV;
+            sameU[j] = static_cast<uint16_t>(compareRows(index, index - strideU));
+            sameV[j] = static_cast<uint16_t>(compareRows(index, index - strideV));
+        }
+    }
+    else if (dim == 1)
+    {
+        // The rows of a slice along y run along z, the rows of blocks along x are compared and then transposed
+        std::array<uint32_t, Size> sameX;
+        std::array<uint32_t, Size> sameZ;
+        for (int z = 0; z < Size; ++z)
+        {
+            const int index = blockIndex + z * strideU;
+            sameX[z] = compareRows(index, index - strideV);
+            sameZ[z] = compareRows(index, index - strideU);
+        }
+        Transpose<Size>(sameZ, sameU.data(), 1);
+        Transpose<Size>(sameX, sameV.data(), 1);
+    }
+    else
+    {
+        // The rows of a slice along x run along y, across the rows of blocks, so only the blocks of faces are read
+        for (uint32_t remainingRows = rows; remainingRows; remainingRows &= remainingRows - 1)
+        {
+            const int j = std::countr_zero(remainingRows);
+
+            uint32_t same = 0;
+            uint32_t sameBelow = 0;
+            for (uint32_t remaining = faces[j]; remaining; remaining &= remaining - 1)
+            {
+                const int i = std::countr_zero(remaining);
+                const int index = blockIndex + i * strideU + j * strideV;
+                const uint8_t blockId = volume.Get(index);
+
+                same |= static_cast<uint32_t>(blockId == volume.Get(index - strideU)) << i;
+                sameBelow |= static_cast<uint32_t>(blockId == volume.Get(index - strideV)) << i;
+            }
+            sameU[j] = static_cast<uint16_t>(same);
+            sameV[j] = static_cast<uint16_t>(sameBelow);
+        }
+    }
+}
+
+template <class Geometry>
+void Blocks::BinaryMesher<Geometry>::MergeFaces(const Volume& volume, uint16_t* faces, const int dim,
+                                                 const int slice, const bool back, MeshScratch<Geometry>& scratch)
+{
+    constexpr int strides[3] = {
+        Volume::GetIndex(1, 0, 0) - Volume::GetIndex(0, 0, 0),
+        Volume::GetIndex(0, 1, 0) - Volume::GetIndex(0, 0, 0),
+        Volume::GetIndex(0, 0, 1) - Volume::GetIndex(0, 0, 0)
+    };
+
+    const int u = (dim + 1) % 3;
+    const int v = (dim + 2) % 3;
+    const int strideU = strides[u];
+    const int strideV = strides[v];
+
+    // Bit j is set for the rows of the slice holding any face, most slices of a section have none at all
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i empty = _mm_packs_epi16(
+        _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(faces)), zero),
+        _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(faces + 8)), zero));
+    const auto rows = static_cast<uint32_t>(~_mm_movemask_epi8(empty) & 0xFFFF);
+    if (!rows) return;
+
+    // The same block id as the greedy mesher, negative if the face points towards the negative axis
+    const int blockIndex = Volume::GetIndex(0, 0, 0) + (slice - (back ? 0 : 1)) * strides[dim];
+    const int sign = back ? -1 : 1;
+    const auto getBlockId = [&volume, blockIndex, sign, strideU, strideV](const int i, const int j)
+    {
+        return sign * static_cast<int>(volume.Get(blockIndex + i * strideU + j * strideV));
+    };
+
+    // Merging then works on the bits alone
+    SameMask sameU{};
+    SameMask sameV{};
+    CompareBlocks(volume, faces, rows, dim, blockIndex, sameU, sameV);
+
+    for (uint32_t remainingRows = rows; remainingRows; remainingRows &= remainingRows - 1)
+    {
+        const int j = std::countr_zero(remainingRows);
+        while (faces[j])
+        {
+            const int i = std::countr_zero(faces[j]);
+            const uint32_t first = uint32_t{1} << i;
+
+            // The faces to the right continue the quad as long as they belong to the same block as their left one
+            const int width = 1 + std::countr_one(static_cast<uint32_t>(faces[j] & sameU[j]) >> (i + 1));
+            const uint32_t run = ((uint32_t{1} << width) - 1) << i;
+            const uint32_t rest = run & ~first;
+
+            // A row above continues the quad if all of its faces exist and belong to the same block as the first one
+            int height = 1;
+            while (j + height < Size)
+            {
+                const int row = j + height;
+                if ((faces[row] & run) != run || !(sameV[row] & first) || (sameU[row] & rest) != rest) break;
+
+                faces[row] &= static_cast<uint16_t>(~run);
+                ++height;
+            }
+            faces[j] &= static_cast<uint16_t>(~run);
+
+            int position[3];
+            position[dim] = slice;
+            position[u] = i;
+            position[v] = j;
+            scratch.AddQuad(dim, {position[0], position[1], position[2]}, width, height, getBlockId(i, j));
+        }
+    }
+}
@@ -0,0 +1,140 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: ChunkMeshData.h
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Blocks/World/BlockRegistry.h"
+#include "BlocksEngine/Core/Math/TerrainVertex.h"
+
+namespace Blocks
+{
+    struct MeshQuad;
+    struct ChunkMeshData;
+}
+
+/**
+ * \brief A quad found by a mesher before its vertices are written, the members match ChunkMeshData::AddQuad.
+ */
+struct Blocks::MeshQuad
+{
+    uint8_t axis;
+    std::array<uint8_t, 3> position;
+    uint8_t width;
+    uint8_t height;
+    int16_t blockId;
+};
+
+/**
+ * \brief The geometry generated for a single chunk section.
+ *
+ * The geometry is a list of quads without indices: quad i consists of the vertices 4i to 4i + 3
+ * and is drawn with the shared index buffer returned by BlocksEngine::IndexBuffer::GetQuadList.
+ * Meshers write the quads ordered by their group, so every direction of the opaque and of the see-through blocks can be
+ * drawn on its own.
+ */
+struct Blocks::ChunkMeshData
+{
+    /**
+     * \brief The number of face directions. The face id of a quad is the one stored in its TerrainVertex.
+     */
+    static constexpr int FaceCount = 6;
+
+    /**
+     * \brief The axis and the sign of the direction every face id points to.
+     */
+    static constexpr std::array<std::pair<int, int>, FaceCount> FaceDirections{
+        {{2, 1}, {0, 1}, {2, -1}, {0, -1}, {1, 1}, {1, -1}}
+    };
+
+    /**
+     * \brief The number of groups of quads: the face ids of opaque blocks followed by the face ids of see-through ones.
+     */
+    static constexpr int GroupCount = FaceCount * 2;
+
+    std::vector<BlocksEngine::TerrainVertex> vertices;
+
+    /**
+     * \brief The face id of a quad facing the given axis.
+     * \param axis The axis the quad faces: 0 for X, 1 for Y and 2 for Z.
+     * \param blockId The block id of the quad, negative if the face points towards the negative axis.
+     */
+    [[nodiscard]] static constexpr int GetFace(const int axis, const int blockId) noexcept
+    {
+        constexpr int faces[3][2] = {{1, 3}, {4, 5}, {0, 2}};
+        return faces[axis][blockId < 0];
+    }
+
+    [[nodiscard]] static constexpr int GetFace(const MeshQuad& quad) noexcept
+    {
+        return GetFace(quad.axis, quad.blockId);
+    }
+
+    /**
+     * \brief The group a quad is drawn in, the face id for opaque blocks and FaceCount plus the face id otherwise.
+     * \param axis The axis the quad faces: 0 for X, 1 for Y and 2 for Z.
+     * \param blockId The block id of the quad, negative if the face points towards the negative axis.
+     * \param seeThrough The table of BlockRegistry::GetSeeThroughTable.
+     */
+    [[nodiscard]] static int GetGroup(const int axis, const int blockId,
+                                      const BlockRegistry::SeeThroughTable& seeThrough) noexcept
+    {
+        return GetFace(axis, blockId) + (seeThrough[blockId < 0 ? -blockId : blockId] ? FaceCount : 0);
+    }
+
+    [[nodiscard]] static int GetGroup(const MeshQuad& quad, const BlockRegistry::SeeThroughTable& seeThrough) noexcept
+    {
+        return GetGroup(quad.axis, quad.blockId, seeThrough);
+    }
+
+    /**
+     * \brief Whether the face of a block towards a neighbouring block is visible. A face is hidden behind an opaque
+     * block and between two blocks of the same see-through kind, e.g. inside a body of glass.
+     * \param blockId The block the face belongs to, air has no faces.
+     * \param neighbourId The block the face points to.
+     * \param seeThrough The table of BlockRegistry::GetSeeThroughTable.
+     */
+    [[nodiscard]] static bool HasFace(const int blockId, const int neighbourId,
+                                      const BlockRegistry::SeeThroughTable& seeThrough) noexcept
+    {
+        return blockId != 0 && blockId != neighbourId && seeThrough[neighbourId];
+    }
+
+    [[nodiscard]] size_t GetQuadCount() const noexcept
+    {
+        return vertices.size() / 4;
+    }
+
+    /**
+     * \brief Removes all quads but keeps the allocated buffers.
+     */
+    void Clear() noexcept;
+
+    /**
+     * \brief Makes room for the given number of quads in every buffer, so adding them does not allocate again.
+     */
+    void Reserve(size_t quadCount);
+
+    /**
+     * \brief Appends a quad found by a mesher. Shared by all meshers so equal quads produce equal vertices.
+     * \param axis The axis the quad faces: 0 for X, 1 for Y and 2 for Z.
+     * \param position The corner of the quad with the lowest coordinates, relative to the section.
+     * \param width The extent of the quad along the axis following the facing axis.
+     * \param height The extent of the quad along the remaining axis.
+     * \param blockId The id of the block the face belongs to. Negative if the face points towards the negative axis.
+     */
+    void AddQuad(int axis, std::array<int, 3> position, int width, int height, int blockId);
+
+    void AddQuad(const MeshQuad& quad);
+};
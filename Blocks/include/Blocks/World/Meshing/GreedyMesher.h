@@ -0,0 +1,184 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: GreedyMesher.h
+
+#pragma once
+
+#include "Blocks/World/Meshing/ChunkMeshData.h"
+#include "Blocks/World/Meshing/Mesher.h"
+
+namespace Blocks
+{
+    template <class Geometry>
+    class GreedyMesher;
+}
+
+/**
+ * \brief Merges adjacent faces with the same texture into as few quads as possible.
+ *
+ * Based on the post of: https://0fps.net/2012/06/30/meshing-in-a-minecraft-game/
+ * and https://github.com/Vercidium/voxel-mesh-generation
+ *
+ * \tparam Geometry The ChunkGeometry of the section to mesh.
+ */
+template <class Geometry>
+class Blocks::GreedyMesher final : public Mesher<Geometry>
+{
+public:
+    using Mesher<Geometry>::Generate;
+
+    [[nodiscard]] std::string_view GetName() const noexcept override;
+
+    /**
+     * \brief Generates the mesh of a single section.
+     * \param getBlockId Returns the block id at a position relative to the section.
+     * Is also called for the neighbouring blocks one outside of the section on every axis.
+     */
+    template <class BlockAccessor>
+    [[nodiscard]] static ChunkMeshData Generate(const BlockAccessor& getBlockId);
+
+protected:
+    void FindQuads(const PaddedVolume<Geometry>& volume, MeshScratch<Geometry>& scratch) const override;
+
+private:
+    template <class BlockAccessor>
+    static void MergeFaces(const BlockAccessor& getBlockId, MeshScratch<Geometry>& scratch);
+};
+
+template <class Geometry>
+void Blocks::GreedyMesher<Geometry>::FindQuads(const PaddedVolume<Geometry>& volume,
+                                               MeshScratch<Geometry>& scratch) const
+{
+    MergeFaces([&volume](const int x, const int y, const int z) { return volume.Get(x, y, z); }, scratch);
+}
+
+template <class Geometry>
+std::string_view Blocks::GreedyMesher<Geometry>::GetName() const noexcept
+{
+    return "greedy";
+}
+
+template <class Geometry>
+template <class BlockAccessor>
+Blocks::ChunkMeshData Blocks::GreedyMesher<Geometry>::Generate(const BlockAccessor& getBlockId)
+{
+    MeshScratch<Geometry>& scratch = MeshScratch<Geometry>::ForCurrentThread();
+
+    scratch.quads.clear();
+    MergeFaces(getBlockId, scratch);
+
+    ChunkMeshData meshData;
+    Mesher<Geometry>::WriteQuads(scratch, meshData);
+    return meshData;
+}
+
+// TODO: Implement https://vercidium.com/blog/voxel-world-optimisations/
+template <class Geometry>
+template <class BlockAccessor>
+void Blocks::GreedyMesher<Geometry>::MergeFaces(const BlockAccessor& getBlockId, MeshScratch<Geometry>& scratch)
+{
+    constexpr int dimensions[3] = {Geometry::Width, Geometry::SectionHeight, Geometry::Depth};
+    const BlockRegistry::SeeThroughTable& seeThrough = BlockRegistry::GetSeeThroughTable();
+
+    // Loop over every axis (x, y, z)
+    for (int dim = 0; dim < 3; ++dim)
+    {
+        int k;
+        const int u = (dim + 1) % 3;
+        const int v = (dim + 2) % 3;
+
+        int x[3] = {0, 0, 0};
+        int q[3] = {0, 0, 0};
+        q[dim] = 1;
+
+        // The faces pointing along the axis are followed by the flipped ones, next to a see-through block both
+        // can exist at the same position
+        const int area = dimensions[u] * dimensions[v];
+        std::vector<int>& masks = scratch.mask;
+        masks.resize(static_cast<size_t>(area) * 2);
+
+        // Check every slice of the chunk
+        for (x[dim] = -1; x[dim] < dimensions[dim];)
+        {
+            // Compute the mask
+            int n = 0;
+            for (x[v] = 0; x[v] < dimensions[v]; ++x[v])
+            {
+                for (x[u] = 0; x[u] < dimensions[u]; ++x[u], ++n)
+                {
+                    const int a = getBlockId(x[0], x[1], x[2]);
+                    const int b = getBlockId(x[0] + q[0], x[1] + q[1], x[2] + q[2]);
+
+                    masks[n] = ChunkMeshData::HasFace(a, b, seeThrough) ? a : 0;
+                    masks[n + area] = ChunkMeshData::HasFace(b, a, seeThrough) ? -b : 0;
+                }
+            }
+
+            ++x[dim];
+
+            // Generate mesh for the current masks
+            for (int side = 0; side < 2; ++side)
+            {
+                int* mask = masks.data() + static_cast<ptrdiff_t>(side) * area;
+                n = 0;
+
+                for (int j = 0; j < dimensions[v]; ++j)
+                {
+                    for (int i = 0; i < dimensions[u];)
+                    {
+                        if (int blockId = mask[n]; static_cast<bool>(blockId))
+                        {
+                            // Compute width of the face
+                            int width = 1;
+                            while (i + width < dimensions[u] && blockId == mask[n + width])
+                            {
+                                ++width;
+                            }
+
+                            // Compute height of the face
+                            int height = 1;
+                            while (j + height < dimensions[v])
+                            {
+                                for (k = 0; k < width; ++k)
+                                {
+                                    if (blockId != mask[n + k + height * dimensions[u]])
+                                    {
+                                        goto afterLoop;
+                                    }
+                                }
+                                ++height;
+                            }
+                        afterLoop:
+
+                            x[u] = i;
+                            x[v] = j;
+
+                            scratch.AddQuad(dim, {x[0], x[1], x[2]}, width, height, blockId);
+
+                            for (int l = 0; l < height; ++l)
+                            {
+                                for (k = 0; k < width; ++k)
+                                {
+                                    mask[n + k + l * dimensions[u]] = 0;
+                                }
+                            }
+
+                            i += width;
+                            n += width;
+                        }
+                        else
+                        {
+                            i++;
+                            n++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
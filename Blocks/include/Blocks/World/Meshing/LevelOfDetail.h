@@ -0,0 +1,214 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: LevelOfDetail.h
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "Blocks/World/Block.h"
+#include "Blocks/World/Meshing/ChunkMeshData.h"
+#include "Blocks/World/Meshing/PaddedVolume.h"
+
+namespace Blocks
+{
+    template <class Geometry>
+    class LevelOfDetail;
+}
+
+/**
+ * \brief Reduces the resolution of a padded volume for sections far away from the player.
+ *
+ * At level n the section is split into cells of 2^n blocks along every axis and every block of a cell is replaced by
+ * the most common block of the cell. The downsampled volume is meshed by the regular meshers, which merge the uniform
+ * cells into the same quads a mesher working on the cells directly would produce.
+ *
+ * The border of the volume is downsampled with the levels of the neighbouring sections, so the faces on both sides of
+ * a border between two levels are generated from the same blocks and no cracks open up in between.
+ *
+ * \tparam Geometry The ChunkGeometry of the section.
+ */
+template <class Geometry>
+class Blocks::LevelOfDetail
+{
+public:
+    /**
+     * \brief The number of levels including the full resolution at level 0. Limited to cells of 8 blocks, and to
+     * cells that never span more than one section.
+     */
+    static constexpr int LevelCount = std::min({
+        4,
+        std::countr_zero(static_cast<unsigned>(Geometry::Width)) + 1,
+        std::countr_zero(static_cast<unsigned>(Geometry::SectionHeight)) + 1,
+        std::countr_zero(static_cast<unsigned>(Geometry::Depth)) + 1
+    });
+
+    /**
+     * \brief The level of the section behind every face of a section, indexed by face id.
+     */
+    using BorderLevels = std::array<int, ChunkMeshData::FaceCount>;
+
+    /**
+     * \brief The number of blocks along every axis of a cell at the given level.
+     */
+    [[nodiscard]] static constexpr int GetCellSize(const int level) noexcept
+    {
+        return 1 << level;
+    }
+
+    /**
+     * \brief Replaces the blocks of a padded volume by the majority block of their cell. Does nothing if the section
+     * and all of its neighbours are at the full resolution.
+     * \param volume The full resolution volume of the section, modified in place.
+     * \param level The level of the section.
+     * \param borderLevels The levels of the neighbouring sections.
+     * \param getBlock Returns the full resolution block id at a position relative to the section. Only called for
+     * the cells of the neighbouring sections, which reach up to one cell beyond the border.
+     */
+    template <class GetBlock>
+    static void Downsample(PaddedVolume<Geometry>& volume, int level, const BorderLevels& borderLevels,
+                           const GetBlock& getBlock) noexcept;
+
+private:
+    // The number of blocks per block id in the current cell, all zero between two cells
+    using Counts = std::array<uint16_t, 256>;
+
+    /**
+     * \brief The most common block of a cell. Ties are won by solid blocks, so thin layers like the surface of the
+     * terrain are kept.
+     */
+    template <class GetBlock>
+    [[nodiscard]] static uint8_t GetMajorityBlock(const GetBlock& getBlock, std::array<int, 3> origin, int size,
+                                                  Counts& counts) noexcept;
+};
+
+template <class Geometry>
+template <class GetBlock>
+void Blocks::LevelOfDetail<Geometry>::Downsample(PaddedVolume<Geometry>& volume, const int level,
+                                                 const BorderLevels& borderLevels, const GetBlock& getBlock) noexcept
+{
+    constexpr int dimensions[3] = {Geometry::Width, Geometry::SectionHeight, Geometry::Depth};
+
+    Counts counts{};
+
+    // Every cell of the interior is read completely before it is overwritten, so the volume is its own source
+    if (level > 0)
+    {
+        const int size = GetCellSize(level);
+        const auto getInteriorBlock = [&volume](const int x, const int y, const int z)
+        {
+            return volume.Get(x, y, z);
+        };
+
+        for (int y = 0; y < Geometry::SectionHeight; y += size)
+        {
+            for (int z = 0; z < Geometry::Depth; z += size)
+            {
+                for (int x = 0; x < Geometry::Width; x += size)
+                {
+                    const uint8_t blockId = GetMajorityBlock(getInteriorBlock, {x, y, z}, size, counts);
+                    for (int dy = 0; dy < size; ++dy)
+                    {
+                        for (int dz = 0; dz < size; ++dz)
+                        {
+                            for (int dx = 0; dx < size; ++dx)
+                            {
+                                volume.Set(x + dx, y + dy, z + dz, blockId);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for (int face = 0; face < ChunkMeshData::FaceCount; ++face)
+    {
+        if (borderLevels[face] == 0) continue;
+
+        const auto [axis, sign] = ChunkMeshData::FaceDirections[face];
+        const int u = (axis + 1) % 3;
+        const int v = (axis + 2) % 3;
+        const int size = GetCellSize(borderLevels[face]);
+
+        // The cells of the neighbour that touch this section and the layer of the border they are written to
+        std::array<int, 3> origin{};
+        origin[axis] = sign > 0 ? dimensions[axis] : -size;
+
+        std::array<int, 3> position{};
+        position[axis] = sign > 0 ? dimensions[axis] : -1;
+
+        for (int j = 0; j < dimensions[v]; j += size)
+        {
+            for (int i = 0; i < dimensions[u]; i += size)
+            {
+                origin[u] = i;
+                origin[v] = j;
+                const uint8_t blockId = GetMajorityBlock(getBlock, origin, size, counts);
+
+                for (position[v] = j; position[v] < j + size; ++position[v])
+                {
+                    for (position[u] = i; position[u] < i + size; ++position[u])
+                    {
+                        volume.Set(position[0], position[1], position[2], blockId);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <class Geometry>
+template <class GetBlock>
+uint8_t Blocks::LevelOfDetail<Geometry>::GetMajorityBlock(const GetBlock& getBlock, const std::array<int, 3> origin,
+                                                          const int size, Counts& counts) noexcept
+{
+    const uint8_t air = Block::Air.GetId();
+    uint8_t majority = air;
+    int majorityCount = 0;
+
+    for (int y = origin[1]; y < origin[1] + size; ++y)
+    {
+        for (int z = origin[2]; z < origin[2] + size; ++z)
+        {
+            for (int x = origin[0]; x < origin[0] + size; ++x)
+            {
+                const uint8_t blockId = getBlock(x, y, z);
+                const int count = ++counts[blockId];
+                if (count > majorityCount || (count == majorityCount && majority == air))
+                {
+                    majority = blockId;
+                    majorityCount = count;
+                }
+            }
+        }
+    }
+
+    // Most cells lie entirely in the air or underground and only touched a single entry
+    if (majorityCount == size * size * size)
+    {
+        counts[majority] = 0;
+        return majority;
+    }
+
+    for (int y = origin[1]; y < origin[1] + size; ++y)
+    {
+        for (int z = origin[2]; z < origin[2] + size; ++z)
+        {
+            for (int x = origin[0]; x < origin[0] + size; ++x)
+            {
+                counts[getBlock(x, y, z)] = 0;
+            }
+        }
+    }
+
+    return majority;
+}
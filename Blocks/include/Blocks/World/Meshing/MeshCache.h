@@ -0,0 +1,168 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: MeshCache.h
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Blocks/World/Meshing/PaddedVolume.h"
+#include "Blocks/World/Meshing/SectionQuads.h"
+#include "BlocksEngine/Graphics/Mesh/Mesh.h"
+#include "BlocksEngine/Graphics/Mesh/VertexBuffer.h"
+
+namespace Blocks
+{
+    template <class Geometry>
+    class MeshCache;
+}
+
+/**
+ * \brief Shares the meshes of sections with identical blocks, e.g. the layers of flat or repetitive terrain.
+ *
+ * Meshes are keyed by the padded volume they were generated from, so two sections only share a mesh if their blocks
+ * and the borders around them are the same. The cache only holds weak references: an entry lives as long as a section
+ * shows it and is released together with its buffers when the last one lets go of it.
+ *
+ * All methods are thread safe, mesh workers look up and insert entries while the main thread detaches them.
+ *
+ * \tparam Geometry The ChunkGeometry of the sections.
+ */
+template <class Geometry>
+class Blocks::MeshCache
+{
+public:
+    /**
+     * \brief The mesh of one padded volume, shared by every section showing it. Never modified while it is cached.
+     */
+    struct Entry
+    {
+        PaddedVolume<Geometry> volume;
+        uint64_t hash;
+
+        std::shared_ptr<BlocksEngine::VertexBuffer> vertexBuffer;
+        std::shared_ptr<BlocksEngine::Mesh> mesh;
+        std::shared_ptr<BlocksEngine::Mesh> translucentMesh;
+        SectionQuads<Geometry> quads;
+    };
+
+    /**
+     * \brief The cache shared by all sections of the given geometry.
+     */
+    [[nodiscard]] static MeshCache& Instance()
+    {
+        static MeshCache cache;
+        return cache;
+    }
+
+    /**
+     * \brief The cached mesh of a volume.
+     * \param volume The padded volume to look up.
+     * \param hash The hash of the volume returned by PaddedVolume::GetHash.
+     * \return Nullptr if no section shows a mesh of this volume.
+     */
+    [[nodiscard]] std::shared_ptr<const Entry> Find(const PaddedVolume<Geometry>& volume, uint64_t hash);
+
+    /**
+     * \brief Adds a newly generated mesh. If another worker cached the same volume in the meantime, its entry is
+     * returned instead so both sections share it.
+     */
+    [[nodiscard]] std::shared_ptr<const Entry> Insert(std::shared_ptr<const Entry> entry);
+
+    /**
+     * \brief Removes an entry from the cache, so its mesh can be modified by the only section that shows it.
+     * \param entry The entry of the calling section.
+     * \return False if any other section or worker still holds the entry.
+     */
+    bool Detach(const std::shared_ptr<const Entry>& entry);
+
+private:
+    MeshCache() = default;
+
+    std::mutex mutex_;
+    std::unordered_multimap<uint64_t, std::weak_ptr<const Entry>> entries_;
+
+    // Released entries are only removed from the map in bulk, once it has grown to twice the size after the last sweep
+    size_t sweepSize_{64};
+
+    /**
+     * \brief Removes the entries of all meshes that are no longer shown. Must be called with the mutex locked.
+     */
+    void Sweep();
+};
+
+template <class Geometry>
+std::shared_ptr<const typename Blocks::MeshCache<Geometry>::Entry> Blocks::MeshCache<Geometry>::Find(
+    const PaddedVolume<Geometry>& volume, const uint64_t hash)
+{
+    std::lock_guard lock{mutex_};
+
+    const auto [first, last] = entries_.equal_range(hash);
+    for (auto it = first; it != last; ++it)
+    {
+        if (std::shared_ptr<const Entry> entry = it->second.lock(); entry && entry->volume == volume)
+        {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+template <class Geometry>
+std::shared_ptr<const typename Blocks::MeshCache<Geometry>::Entry> Blocks::MeshCache<Geometry>::Insert(
+    std::shared_ptr<const Entry> entry)
+{
+    std::lock_guard lock{mutex_};
+
+    const auto [first, last] = entries_.equal_range(entry->hash);
+    for (auto it = first; it != last; ++it)
+    {
+        if (std::shared_ptr<const Entry> existing = it->second.lock(); existing && existing->volume == entry->volume)
+        {
+            return existing;
+        }
+    }
+
+    entries_.emplace(entry->hash, entry);
+    if (entries_.size() >= sweepSize_)
+    {
+        Sweep();
+    }
+    return entry;
+}
+
+template <class Geometry>
+bool Blocks::MeshCache<Geometry>::Detach(const std::shared_ptr<const Entry>& entry)
+{
+    std::lock_guard lock{mutex_};
+
+    // Other holders can only lock the weak references while the mutex is held, so the count can not grow meanwhile
+    if (entry.use_count() > 1) return false;
+
+    const auto [first, last] = entries_.equal_range(entry->hash);
+    for (auto it = first; it != last; ++it)
+    {
+        if (!it->second.owner_before(entry) && !entry.owner_before(it->second))
+        {
+            entries_.erase(it);
+            break;
+        }
+    }
+    return true;
+}
+
+template <class Geometry>
+void Blocks::MeshCache<Geometry>::Sweep()
+{
+    std::erase_if(entries_, [](const auto& entry) { return entry.second.expired(); });
+    sweepSize_ = std::max<size_t>(64, entries_.size() * 2);
+}
@@ -0,0 +1,76 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: MeshScratch.h
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Blocks/World/Meshing/ChunkMeshData.h"
+#include "Blocks/World/Meshing/PaddedVolume.h"
+
+namespace Blocks
+{
+    template <class Geometry>
+    struct MeshScratch;
+}
+
+/**
+ * \brief The temporary buffers of a mesh worker, reused by every section it meshes.
+ *
+ * Every thread owns one scratch per geometry, so mesh workers never share or lock these buffers. The vectors are
+ * only cleared between sections and keep their capacity, once a worker has meshed its largest section it no longer
+ * allocates anything but the exactly sized output it hands to the main thread.
+ *
+ * \tparam Geometry The ChunkGeometry of the sections to mesh.
+ */
+template <class Geometry>
+struct Blocks::MeshScratch
+{
+    // The blocks of the section that is being meshed
+    PaddedVolume<Geometry> volume;
+
+    // The output of the section that is being meshed, the render vertices only have to live until they are uploaded
+    ChunkMeshData meshData;
+
+    // The quads found by the mesher, counted before the output is written
+    std::vector<MeshQuad> quads;
+
+    // The quads sorted by group, swapped with quads once they are grouped
+    std::vector<MeshQuad> groupedQuads;
+
+    // The faces of a single slice in both directions, used by the greedy mesher
+    std::vector<int> mask;
+
+    /**
+     * \brief Collects a quad found by a mesher, its vertices are written once all quads of the section are known.
+     * The parameters are the same as for ChunkMeshData::AddQuad.
+     */
+    void AddQuad(const int axis, const std::array<int, 3> position, const int width, const int height,
+                 const int blockId)
+    {
+        quads.push_back({
+            static_cast<uint8_t>(axis),
+            {static_cast<uint8_t>(position[0]), static_cast<uint8_t>(position[1]), static_cast<uint8_t>(position[2])},
+            static_cast<uint8_t>(width),
+            static_cast<uint8_t>(height),
+            static_cast<int16_t>(blockId)
+        });
+    }
+
+    /**
+     * \brief The scratch of the calling thread, created the first time the thread meshes a section.
+     */
+    [[nodiscard]] static MeshScratch& ForCurrentThread()
+    {
+        thread_local MeshScratch scratch;
+        return scratch;
+    }
+};
@@ -0,0 +1,130 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: Mesher.h
+
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+#include "Blocks/World/Meshing/ChunkMeshData.h"
+#include "Blocks/World/Meshing/MeshScratch.h"
+#include "Blocks/World/Meshing/PaddedVolume.h"
+
+namespace Blocks
+{
+    template <class Geometry>
+    class Mesher;
+}
+
+/**
+ * \brief A strategy turning the blocks of a section into its render geometry.
+ *
+ * Meshers are stateless and shared between all mesh workers, Generate is therefore called from many threads at once.
+ * Every mesher has to produce quads covering exactly the visible faces of the section as decided by
+ * ChunkMeshData::HasFace, how the faces are merged into quads is up to the strategy. Next to a see-through block a
+ * position can hold two faces pointing in opposite directions.
+ *
+ * Meshing counts before it writes: a mesher only collects its quads in the scratch of the calling thread, the vertices
+ * are written afterwards into outputs that are sized exactly once. Apart from growing the scratch the first few times,
+ * the only allocations are the output buffers, which callers can also reuse across sections.
+ *
+ * \tparam Geometry The ChunkGeometry of the sections to mesh.
+ */
+template <class Geometry>
+class Blocks::Mesher
+{
+public:
+    virtual ~Mesher() = default;
+
+    /**
+     * \brief Generates the mesh of a single section into new buffers of exactly the required size.
+     * \param volume The blocks of the section including the border of its neighbours.
+     */
+    [[nodiscard]] ChunkMeshData Generate(const PaddedVolume<Geometry>& volume) const;
+
+    /**
+     * \brief Generates the mesh of a single section, replacing the contents of meshData but keeping its buffers.
+     * The quads of the section stay in the scratch of the calling thread until it meshes the next section.
+     * \param volume The blocks of the section including the border of its neighbours.
+     * \param meshData The output, its buffers only grow if the section needs more space than any before.
+     */
+    void Generate(const PaddedVolume<Geometry>& volume, ChunkMeshData& meshData) const;
+
+    /**
+     * \brief The name used to select the mesher on the command line and in benchmark results.
+     */
+    [[nodiscard]] virtual std::string_view GetName() const noexcept = 0;
+
+protected:
+    /**
+     * \brief Finds the quads covering the visible faces of a section.
+     * \param volume The blocks of the section including the border of its neighbours.
+     * \param scratch The buffers of the calling thread. The quads are appended to scratch.quads, which is empty.
+     */
+    virtual void FindQuads(const PaddedVolume<Geometry>& volume, MeshScratch<Geometry>& scratch) const = 0;
+
+    /**
+     * \brief Sorts the quads in scratch.quads by ChunkMeshData::GetGroup and writes their vertices into meshData after
+     * reserving exactly enough space. The quads in scratch.quads are left in the same order as their vertices.
+     */
+    static void WriteQuads(MeshScratch<Geometry>& scratch, ChunkMeshData& meshData);
+};
+
+template <class Geometry>
+Blocks::ChunkMeshData Blocks::Mesher<Geometry>::Generate(const PaddedVolume<Geometry>& volume) const
+{
+    ChunkMeshData meshData;
+    Generate(volume, meshData);
+    return meshData;
+}
+
+template <class Geometry>
+void Blocks::Mesher<Geometry>::Generate(const PaddedVolume<Geometry>& volume, ChunkMeshData& meshData) const
+{
+    MeshScratch<Geometry>& scratch = MeshScratch<Geometry>::ForCurrentThread();
+
+    scratch.quads.clear();
+    FindQuads(volume, scratch);
+
+    meshData.Clear();
+    WriteQuads(scratch, meshData);
+}
+
+template <class Geometry>
+void Blocks::Mesher<Geometry>::WriteQuads(MeshScratch<Geometry>& scratch, ChunkMeshData& meshData)
+{
+    const BlockRegistry::SeeThroughTable& seeThrough = BlockRegistry::GetSeeThroughTable();
+
+    // A counting sort keeps the order of the quads within every group
+    std::array<size_t, ChunkMeshData::GroupCount + 1> offsets{};
+    for (const MeshQuad& quad : scratch.quads)
+    {
+        ++offsets[ChunkMeshData::GetGroup(quad, seeThrough) + 1];
+    }
+
+    for (int group = 1; group <= ChunkMeshData::GroupCount; ++group)
+    {
+        offsets[group] += offsets[group - 1];
+    }
+
+    scratch.groupedQuads.resize(scratch.quads.size());
+    for (const MeshQuad& quad : scratch.quads)
+    {
+        scratch.groupedQuads[offsets[ChunkMeshData::GetGroup(quad, seeThrough)]++] = quad;
+    }
+    std::swap(scratch.quads, scratch.groupedQuads);
+
+    meshData.Reserve(scratch.quads.size());
+
+    for (const MeshQuad& quad : scratch.quads)
+    {
+        meshData.AddQuad(quad);
+    }
+}
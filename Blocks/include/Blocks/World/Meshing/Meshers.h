@@ -0,0 +1,50 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: Meshers.h
+
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "Blocks/World/Meshing/BinaryMesher.h"
+#include "Blocks/World/Meshing/GreedyMesher.h"
+#include "Blocks/World/Meshing/Mesher.h"
+#include "Blocks/World/Meshing/NaiveMesher.h"
+
+namespace Blocks
+{
+    /**
+     * \brief Every available mesher, ordered from the simplest to the fastest.
+     * The first one is the reference the benchmark compares all others against.
+     */
+    template <class Geometry>
+    [[nodiscard]] std::vector<std::shared_ptr<const Mesher<Geometry>>> GetMeshers()
+    {
+        return {
+            std::make_shared<NaiveMesher<Geometry>>(),
+            std::make_shared<GreedyMesher<Geometry>>(),
+            std::make_shared<BinaryMesher<Geometry>>()
+        };
+    }
+
+    /**
+     * \return The mesher with the given name, nullptr if there is none.
+     */
+    template <class Geometry>
+    [[nodiscard]] std::shared_ptr<const Mesher<Geometry>> FindMesher(const std::string_view name)
+    {
+        for (auto& mesher : GetMeshers<Geometry>())
+        {
+            if (mesher->GetName() == name) return mesher;
+        }
+
+        return nullptr;
+    }
+}
@@ -0,0 +1,81 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: NaiveMesher.h
+
+#pragma once
+
+#include "Blocks/World/Meshing/Mesher.h"
+
+namespace Blocks
+{
+    template <class Geometry>
+    class NaiveMesher;
+}
+
+/**
+ * \brief Emits one quad for every visible block face without merging any of them.
+ * The slowest to render but the simplest to reason about, used as the reference for the other meshers.
+ *
+ * \tparam Geometry The ChunkGeometry of the section to mesh.
+ */
+template <class Geometry>
+class Blocks::NaiveMesher final : public Mesher<Geometry>
+{
+public:
+    [[nodiscard]] std::string_view GetName() const noexcept override;
+
+protected:
+    void FindQuads(const PaddedVolume<Geometry>& volume, MeshScratch<Geometry>& scratch) const override;
+};
+
+template <class Geometry>
+void Blocks::NaiveMesher<Geometry>::FindQuads(const PaddedVolume<Geometry>& volume,
+                                               MeshScratch<Geometry>& scratch) const
+{
+    constexpr int dimensions[3] = {Geometry::Width, Geometry::SectionHeight, Geometry::Depth};
+    const BlockRegistry::SeeThroughTable& seeThrough = BlockRegistry::GetSeeThroughTable();
+
+    for (int dim = 0; dim < 3; ++dim)
+    {
+        const int u = (dim + 1) % 3;
+        const int v = (dim + 2) % 3;
+
+        int q[3] = {0, 0, 0};
+        q[dim] = 1;
+
+        // A face lies between the block at x and the next block along the axis
+        int x[3] = {0, 0, 0};
+        for (x[dim] = -1; x[dim] < dimensions[dim]; ++x[dim])
+        {
+            for (x[v] = 0; x[v] < dimensions[v]; ++x[v])
+            {
+                for (x[u] = 0; x[u] < dimensions[u]; ++x[u])
+                {
+                    const int a = volume.Get(x[0], x[1], x[2]);
+                    const int b = volume.Get(x[0] + q[0], x[1] + q[1], x[2] + q[2]);
+
+                    if (ChunkMeshData::HasFace(a, b, seeThrough))
+                    {
+                        scratch.AddQuad(dim, {x[0] + q[0], x[1] + q[1], x[2] + q[2]}, 1, 1, a);
+                    }
+
+                    if (ChunkMeshData::HasFace(b, a, seeThrough))
+                    {
+                        scratch.AddQuad(dim, {x[0] + q[0], x[1] + q[1], x[2] + q[2]}, 1, 1, -b);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <class Geometry>
+std::string_view Blocks::NaiveMesher<Geometry>::GetName() const noexcept
+{
+    return "naive";
+}
@@ -0,0 +1,136 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: PaddedVolume.h
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace Blocks
+{
+    template <class Geometry>
+    class PaddedVolume;
+}
+
+/**
+ * \brief A copy of the block ids of a section including a one block border of its neighbours.
+ *
+ * Meshing only needs to read this contiguous array and never has to look up neighbouring sections or chunks.
+ * Coordinates are relative to the section and range from -1 up to and including the section dimensions.
+ *
+ * \tparam Geometry The ChunkGeometry of the section.
+ */
+template <class Geometry>
+class Blocks::PaddedVolume
+{
+public:
+    static constexpr int Width = Geometry::Width + 2;
+    static constexpr int Height = Geometry::SectionHeight + 2;
+    static constexpr int Depth = Geometry::Depth + 2;
+    static constexpr int Size = Width * Height * Depth;
+
+    [[nodiscard]] uint8_t Get(const int x, const int y, const int z) const noexcept
+    {
+        return blocks_[GetIndex(x, y, z)];
+    }
+
+    /**
+     * \param index The index returned by GetIndex.
+     */
+    [[nodiscard]] uint8_t Get(const int index) const noexcept
+    {
+        return blocks_[index];
+    }
+
+    /**
+     * \brief The Width block ids along the x axis starting at x = -1.
+     */
+    [[nodiscard]] std::span<const uint8_t, Width> GetRow(const int y, const int z) const noexcept
+    {
+        return std::span<const uint8_t, Width>{&blocks_[GetIndex(-1, y, z)], Width};
+    }
+
+    /**
+     * \brief The block ids from the given index on, for reading many of them at once.
+     * \param index The index returned by GetIndex.
+     */
+    [[nodiscard]] const uint8_t* GetData(const int index) const noexcept
+    {
+        return &blocks_[index];
+    }
+
+    void Set(const int x, const int y, const int z, const uint8_t blockId) noexcept
+    {
+        blocks_[GetIndex(x, y, z)] = blockId;
+    }
+
+    [[nodiscard]] static constexpr int GetIndex(const int x, const int y, const int z) noexcept
+    {
+        return x + 1 + Width * (z + 1 + Depth * (y + 1));
+    }
+
+    /**
+     * \brief A hash of all block ids including the border. Volumes that compare equal produce the same mesh.
+     */
+    [[nodiscard]] uint64_t GetHash() const noexcept
+    {
+        // FNV-1a over words of 8 blocks. A product only carries the low bits of a word upwards, so the high half
+        // is folded back down after every word. Consecutive words go to four lanes, so their multiplications do not
+        // wait for each other, and the lanes are combined at the end.
+        constexpr uint64_t basis = 0xCBF29CE484222325;
+        uint64_t lane0 = basis;
+        uint64_t lane1 = basis;
+        uint64_t lane2 = basis;
+        uint64_t lane3 = basis;
+
+        int i = 0;
+        for (; i + 32 <= Size; i += 32)
+        {
+            lane0 = MixWord(lane0, &blocks_[i]);
+            lane1 = MixWord(lane1, &blocks_[i + 8]);
+            lane2 = MixWord(lane2, &blocks_[i + 16]);
+            lane3 = MixWord(lane3, &blocks_[i + 24]);
+        }
+
+        uint64_t hash = Mix(Mix(Mix(lane0, lane1), lane2), lane3);
+        for (; i + 8 <= Size; i += 8)
+        {
+            hash = MixWord(hash, &blocks_[i]);
+        }
+        for (; i < Size; ++i)
+        {
+            hash = Mix(hash, blocks_[i]);
+        }
+
+        return hash;
+    }
+
+    [[nodiscard]] bool operator==(const PaddedVolume& other) const noexcept
+    {
+        return blocks_ == other.blocks_;
+    }
+
+private:
+    std::array<uint8_t, Size> blocks_{};
+
+    [[nodiscard]] static constexpr uint64_t Mix(const uint64_t hash, const uint64_t word) noexcept
+    {
+        const uint64_t product = (hash ^ word) * 0x100000001B3;
+        return product ^ product >> 32;
+    }
+
+    [[nodiscard]] static uint64_t MixWord(const uint64_t hash, const uint8_t* blocks) noexcept
+    {
+        uint64_t word;
+        std::memcpy(&word, blocks, sizeof(word));
+        return Mix(hash, word);
+    }
+};
@@ -0,0 +1,390 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: SectionQuads.h
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Blocks/World/Meshing/ChunkMeshData.h"
+
+namespace Blocks
+{
+    template <class Geometry>
+    class SectionQuads;
+}
+
+/**
+ * \brief The quads of the current mesh of a section, kept to patch the mesh after a single block changed.
+ *
+ * A patch only touches the quads covering the faces of the changed block: a quad whose face changed is split into
+ * the rectangles around that face and the new face is merged into an adjacent quad where possible.
+ *
+ * The quads of every group occupy their own contiguous range of slots, so every direction of the opaque and of the
+ * see-through blocks can be drawn and culled on its own. Slot i is drawn with the vertices 4i to 4i + 3. Every range
+ * has spare slots after its quads, removed
+ * quads are replaced by the last quad of their range so only the changed slots have to be uploaded again. Every patch
+ * fragments the mesh a little, once a range runs out of spare slots the section has to be meshed from scratch.
+ *
+ * \tparam Geometry The ChunkGeometry of the section.
+ */
+template <class Geometry>
+class Blocks::SectionQuads
+{
+public:
+    static constexpr int GroupCount = ChunkMeshData::GroupCount;
+
+    /**
+     * \brief The number of slots reserved for a group with the given number of quads.
+     */
+    [[nodiscard]] static constexpr uint32_t GetCapacity(const size_t quadCount) noexcept
+    {
+        return static_cast<uint32_t>(quadCount + quadCount / 4 + 4);
+    }
+
+    /**
+     * \brief Replaces the quads with the ones of a freshly generated mesh.
+     * \param quads The quads sorted by group, as written by the meshers.
+     */
+    void Reset(const std::vector<MeshQuad>& quads)
+    {
+        for (auto& groupQuads : quads_)
+        {
+            groupQuads.clear();
+        }
+
+        const BlockRegistry::SeeThroughTable& seeThrough = BlockRegistry::GetSeeThroughTable();
+        for (const MeshQuad& quad : quads)
+        {
+            quads_[ChunkMeshData::GetGroup(quad, seeThrough)].push_back(quad);
+        }
+
+        uint32_t offset = 0;
+        for (int group = 0; group < GroupCount; ++group)
+        {
+            offsets_[group] = offset;
+            offset += GetCapacity(quads_[group].size());
+        }
+        slotCount_ = offset;
+
+        changedSlots_.clear();
+    }
+
+    /**
+     * \brief The quads of a single group, the quad at index i occupies the slot GetOffset(group) + i.
+     */
+    [[nodiscard]] const std::vector<MeshQuad>& GetQuads(const int group) const noexcept
+    {
+        return quads_[group];
+    }
+
+    /**
+     * \brief The first slot of the range of a group.
+     */
+    [[nodiscard]] uint32_t GetOffset(const int group) const noexcept
+    {
+        return offsets_[group];
+    }
+
+    /**
+     * \brief The number of slots of all ranges including the spare ones.
+     */
+    [[nodiscard]] uint32_t GetSlotCount() const noexcept
+    {
+        return slotCount_;
+    }
+
+    [[nodiscard]] const MeshQuad& GetQuad(const uint32_t slot) const noexcept
+    {
+        const int group = GetGroup(slot);
+        return quads_[group][slot - offsets_[group]];
+    }
+
+    /**
+     * \brief The slots changed by the last patch, sorted and all occupied by a quad.
+     */
+    [[nodiscard]] const std::vector<uint32_t>& GetChangedSlots() const noexcept
+    {
+        return changedSlots_;
+    }
+
+    /**
+     * \brief Moves vertices written in the order of the quads passed to Reset to the slots of their quads.
+     * The spare slots are filled with empty vertices.
+     */
+    void SpreadVertices(std::vector<BlocksEngine::TerrainVertex>& vertices) const;
+
+    /**
+     * \brief Updates the faces of a changed block.
+     * \param position The changed block relative to the section, from -1 up to and including the section dimensions.
+     * \param getBlockId Returns the current block id at a position relative to the section.
+     * \return False if a range ran out of spare slots, the quads are then no longer valid and have to be replaced.
+     */
+    template <class BlockAccessor>
+    bool PatchBlock(std::array<int, 3> position, const BlockAccessor& getBlockId);
+
+private:
+    std::array<std::vector<MeshQuad>, GroupCount> quads_{};
+    std::array<uint32_t, GroupCount> offsets_{};
+    uint32_t slotCount_{0};
+
+    std::vector<uint32_t> changedSlots_{};
+
+    void Add(const MeshQuad& quad);
+    void Remove(int group, size_t index);
+
+    /**
+     * \brief Removes the face at (i, j) of a slice pointing in the direction of a face id, splitting the quad
+     * covering it into the rectangles around it.
+     * \return False if the face is already covered by a quad with the given block id and was kept.
+     */
+    bool RemoveFace(int axis, int slice, int i, int j, int face, int blockId);
+
+    /**
+     * \brief Sets the face at (i, j) of a slice, merging it into an adjacent quad with the same block id if possible.
+     */
+    void AddFace(int axis, int slice, int i, int j, int blockId);
+
+    [[nodiscard]] int GetGroup(const uint32_t slot) const noexcept
+    {
+        int group = GroupCount - 1;
+        while (offsets_[group] > slot) --group;
+        return group;
+    }
+
+    [[nodiscard]] uint32_t GetRangeEnd(const int group) const noexcept
+    {
+        return group + 1 < GroupCount ? offsets_[group + 1] : slotCount_;
+    }
+};
+
+template <class Geometry>
+void Blocks::SectionQuads<Geometry>::SpreadVertices(std::vector<BlocksEngine::TerrainVertex>& vertices) const
+{
+    std::array<size_t, GroupCount> starts{};
+    for (int group = 1; group < GroupCount; ++group)
+    {
+        starts[group] = starts[group - 1] + quads_[group - 1].size();
+    }
+
+    vertices.resize(static_cast<size_t>(slotCount_) * 4);
+
+    // Every range only moves towards the end, starting with the last one nothing is overwritten before it is moved
+    for (int group = GroupCount - 1; group >= 0; --group)
+    {
+        const auto source = vertices.begin() + static_cast<ptrdiff_t>(starts[group] * 4);
+        const auto destination = vertices.begin() + static_cast<ptrdiff_t>(offsets_[group]) * 4;
+        const auto count = static_cast<ptrdiff_t>(quads_[group].size() * 4);
+
+        std::copy_backward(source, source + count, destination + count);
+        std::fill(destination + count, vertices.begin() + static_cast<ptrdiff_t>(GetRangeEnd(group)) * 4,
+                  BlocksEngine::TerrainVertex{});
+    }
+}
+
+template <class Geometry>
+template <class BlockAccessor>
+bool Blocks::SectionQuads<Geometry>::PatchBlock(const std::array<int, 3> position, const BlockAccessor& getBlockId)
+{
+    constexpr int dimensions[3] = {Geometry::Width, Geometry::SectionHeight, Geometry::Depth};
+    const BlockRegistry::SeeThroughTable& seeThrough = BlockRegistry::GetSeeThroughTable();
+
+    changedSlots_.clear();
+
+    for (int dim = 0; dim < 3; ++dim)
+    {
+        const int u = (dim + 1) % 3;
+        const int v = (dim + 2) % 3;
+
+        const int i = position[u];
+        const int j = position[v];
+        if (i < 0 || i >= dimensions[u] || j < 0 || j >= dimensions[v]) continue;
+
+        // The block has a face in the slice before and after it, slice s lies between the blocks at s - 1 and s
+        for (int slice = position[dim]; slice <= position[dim] + 1; ++slice)
+        {
+            if (slice < 0 || slice > dimensions[dim]) continue;
+
+            int x[3];
+            x[dim] = slice - 1;
+            x[u] = i;
+            x[v] = j;
+            const int a = getBlockId(x[0], x[1], x[2]);
+            ++x[dim];
+            const int b = getBlockId(x[0], x[1], x[2]);
+
+            // The same block ids as the meshers for the face pointing along the axis and the flipped one
+            const int blockIds[2] = {
+                ChunkMeshData::HasFace(a, b, seeThrough) ? a : 0,
+                ChunkMeshData::HasFace(b, a, seeThrough) ? -b : 0
+            };
+
+            for (int side = 0; side < 2; ++side)
+            {
+                const int blockId = blockIds[side];
+                const int face = ChunkMeshData::GetFace(dim, side ? -1 : 1);
+
+                if (RemoveFace(dim, slice, i, j, face, blockId) && blockId)
+                {
+                    AddFace(dim, slice, i, j, blockId);
+                }
+            }
+        }
+    }
+
+    for (int group = 0; group < GroupCount; ++group)
+    {
+        if (offsets_[group] + quads_[group].size() > GetRangeEnd(group)) return false;
+    }
+
+    // Slots that were moved or merged several times are only uploaded once
+    std::ranges::sort(changedSlots_);
+    const auto [first, last] = std::ranges::unique(changedSlots_);
+    changedSlots_.erase(first, last);
+
+    std::erase_if(changedSlots_, [this](const uint32_t slot)
+    {
+        const int group = GetGroup(slot);
+        return slot - offsets_[group] >= quads_[group].size();
+    });
+    return true;
+}
+
+template <class Geometry>
+void Blocks::SectionQuads<Geometry>::Add(const MeshQuad& quad)
+{
+    const int group = ChunkMeshData::GetGroup(quad, BlockRegistry::GetSeeThroughTable());
+    changedSlots_.push_back(offsets_[group] + static_cast<uint32_t>(quads_[group].size()));
+    quads_[group].push_back(quad);
+}
+
+template <class Geometry>
+void Blocks::SectionQuads<Geometry>::Remove(const int group, const size_t index)
+{
+    std::vector<MeshQuad>& groupQuads = quads_[group];
+    groupQuads[index] = groupQuads.back();
+    groupQuads.pop_back();
+    changedSlots_.push_back(offsets_[group] + static_cast<uint32_t>(index));
+}
+
+template <class Geometry>
+bool Blocks::SectionQuads<Geometry>::RemoveFace(const int axis, const int slice, const int i, const int j,
+                                                const int face, const int blockId)
+{
+    const int u = (axis + 1) % 3;
+    const int v = (axis + 2) % 3;
+
+    // An opaque and a see-through quad pointing in the same direction never cover the same face
+    for (const int group : {face, face + ChunkMeshData::FaceCount})
+    {
+        std::vector<MeshQuad>& groupQuads = quads_[group];
+        const auto covering = std::ranges::find_if(groupQuads, [axis, u, v, slice, i, j](const MeshQuad& quad)
+        {
+            return quad.position[axis] == slice
+                && quad.position[u] <= i && i < quad.position[u] + quad.width
+                && quad.position[v] <= j && j < quad.position[v] + quad.height;
+        });
+
+        if (covering == groupQuads.end()) continue;
+        if (covering->blockId == blockId) return false;
+
+        // Split the quad into the rows below and above the face and the parts left and right of it
+        const MeshQuad quad = *covering;
+        Remove(group, covering - groupQuads.begin());
+
+        const int minU = quad.position[u];
+        const int minV = quad.position[v];
+        const int maxU = minU + quad.width;
+        const int maxV = minV + quad.height;
+
+        const auto addPart = [this, &quad, u, v](const int partU, const int partV, const int width, const int height)
+        {
+            if (width <= 0 || height <= 0) return;
+
+            MeshQuad part = quad;
+            part.position[u] = static_cast<uint8_t>(partU);
+            part.position[v] = static_cast<uint8_t>(partV);
+            part.width = static_cast<uint8_t>(width);
+            part.height = static_cast<uint8_t>(height);
+            Add(part);
+        };
+
+        addPart(minU, minV, maxU - minU, j - minV);
+        addPart(minU, j + 1, maxU - minU, maxV - j - 1);
+        addPart(minU, j, i - minU, 1);
+        addPart(i + 1, j, maxU - i - 1, 1);
+        break;
+    }
+
+    return true;
+}
+
+template <class Geometry>
+void Blocks::SectionQuads<Geometry>::AddFace(const int axis, const int slice, const int i, const int j,
+                                             const int blockId)
+{
+    const int u = (axis + 1) % 3;
+    const int v = (axis + 2) % 3;
+
+    const int group = ChunkMeshData::GetGroup(axis, blockId, BlockRegistry::GetSeeThroughTable());
+    std::vector<MeshQuad>& groupQuads = quads_[group];
+
+    for (size_t index = 0; index < groupQuads.size(); ++index)
+    {
+        MeshQuad& quad = groupQuads[index];
+        if (quad.position[axis] != slice || quad.blockId != blockId) continue;
+
+        const int quadU = quad.position[u];
+        const int quadV = quad.position[v];
+
+        // A quad one face high can grow along u, a quad one face wide along v
+        if (quad.height == 1 && quadV == j)
+        {
+            if (quadU + quad.width == i)
+            {
+                ++quad.width;
+            }
+            else if (quadU == i + 1)
+            {
+                --quad.position[u];
+                ++quad.width;
+            }
+            else continue;
+        }
+        else if (quad.width == 1 && quadU == i)
+        {
+            if (quadV + quad.height == j)
+            {
+                ++quad.height;
+            }
+            else if (quadV == j + 1)
+            {
+                --quad.position[v];
+                ++quad.height;
+            }
+            else continue;
+        }
+        else continue;
+
+        changedSlots_.push_back(offsets_[group] + static_cast<uint32_t>(index));
+        return;
+    }
+
+    MeshQuad quad{};
+    quad.axis = static_cast<uint8_t>(axis);
+    quad.position[axis] = static_cast<uint8_t>(slice);
+    quad.position[u] = static_cast<uint8_t>(i);
+    quad.position[v] = static_cast<uint8_t>(j);
+    quad.width = 1;
+    quad.height = 1;
+    quad.blockId = static_cast<int16_t>(blockId);
+    Add(quad);
+}
@@ -0,0 +1,115 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: SectionOccupancy.h
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "ChunkGeometry.h"
+
+namespace Blocks
+{
+    class BlockStorage;
+
+    class SectionOccupancy;
+}
+
+/**
+ * \brief Summarizes which blocks of a section are occupied so common queries do not need to visit every block.
+ *
+ * Keeps the number of non air and opaque blocks and one bitmask per column, where bit y is set if the block at
+ * height y of the section is not air. Every change of a block updates the summary in constant time.
+ */
+class Blocks::SectionOccupancy
+{
+public:
+    //------------------------------------------------------------------------------
+    // Types
+    //------------------------------------------------------------------------------
+
+    using Geometry = DefaultChunkGeometry;
+
+    /**
+     * \brief The smallest unsigned integer with one bit per block of a section column.
+     */
+    using ColumnMask = std::conditional_t<Geometry::SectionHeight <= 8, uint8_t,
+                                          std::conditional_t<Geometry::SectionHeight <= 16, uint16_t,
+                                                             std::conditional_t<Geometry::SectionHeight <= 32,
+                                                                                uint32_t, uint64_t>>>;
+
+    static_assert(Geometry::SectionHeight <= 64, "A section column must fit into a 64 bit mask");
+
+
+    //------------------------------------------------------------------------------
+    // Constructors
+    //------------------------------------------------------------------------------
+
+    /**
+     * \brief Creates the occupancy of a section that only contains air.
+     */
+    SectionOccupancy() noexcept = default;
+
+    /**
+     * \brief Computes the occupancy of the given blocks.
+     * \param blocks The blocks of a section, indexed by Geometry::GetSectionFlatIndex.
+     */
+    explicit SectionOccupancy(const BlockStorage& blocks);
+
+
+    //------------------------------------------------------------------------------
+    // Methods
+    //------------------------------------------------------------------------------
+
+    /**
+     * \brief Updates the occupancy after a single block of the section changed.
+     * \param x The x coordinate of the block in the section.
+     * \param y The y coordinate of the block in the section.
+     * \param z The z coordinate of the block in the section.
+     * \param previousId The id the block had before the change.
+     * \param blockId The new id of the block.
+     */
+    void OnBlockChanged(int x, int y, int z, uint8_t previousId, uint8_t blockId);
+
+    [[nodiscard]] int GetNonAirCount() const noexcept;
+    [[nodiscard]] int GetOpaqueCount() const noexcept;
+
+    /**
+     * \brief Whether every block of the section is air.
+     */
+    [[nodiscard]] bool IsEmpty() const noexcept;
+
+    /**
+     * \brief Whether every block of the section is opaque. Nothing behind a full section is visible.
+     */
+    [[nodiscard]] bool IsFull() const noexcept;
+
+    [[nodiscard]] ColumnMask GetColumnMask(int x, int z) const noexcept;
+
+    /**
+     * \brief The height of the highest non air block in a column of the section.
+     * \return The y coordinate in the section or -1 if the column only contains air.
+     */
+    [[nodiscard]] int GetHighestBlock(int x, int z) const noexcept;
+
+    [[nodiscard]] static bool IsOpaque(uint8_t blockId);
+
+private:
+    int nonAirCount_{0};
+    int opaqueCount_{0};
+    std::array<ColumnMask, Geometry::Width * Geometry::Depth> columns_{};
+
+    [[nodiscard]] static constexpr int GetColumnIndex(int x, int z) noexcept;
+};
+
+constexpr int Blocks::SectionOccupancy::GetColumnIndex(const int x, const int z) noexcept
+{
+    return x + z * Geometry::Width;
+}
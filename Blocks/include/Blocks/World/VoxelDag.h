@@ -0,0 +1,138 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: VoxelDag.h
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "ChunkGeometry.h"
+
+namespace Blocks
+{
+    class VoxelDag;
+}
+
+/**
+ * \brief Archival storage for the blocks of sections as a sparse voxel octree where identical subtrees are shared.
+ *
+ * Every section is stored as an octree. Subtrees that only contain a single block id are not stored at all,
+ * all other nodes are deduplicated, so identical subtrees of any section stored in the same DAG, including
+ * those of other chunks, are stored once. Nodes are reference counted and released once no section uses them.
+ *
+ * Reading single blocks is slow, sections are expected to be expanded into a BlockStorage before they are used, or
+ * only the region that is needed, like the faces a neighbour is meshed against. Not thread safe.
+ */
+class Blocks::VoxelDag
+{
+public:
+    //------------------------------------------------------------------------------
+    // Types
+    //------------------------------------------------------------------------------
+
+    using Geometry = DefaultChunkGeometry;
+
+    /**
+     * \brief Either the index of a node or, if UniformFlag is set, a subtree where every block has the same id.
+     */
+    using NodeRef = uint32_t;
+
+    static constexpr NodeRef UniformFlag = 0x80000000u;
+
+    static_assert(Geometry::Width == Geometry::Depth && Geometry::Width == Geometry::SectionHeight,
+        "The octree requires cubic sections");
+
+
+    //------------------------------------------------------------------------------
+    // Methods
+    //------------------------------------------------------------------------------
+
+    /**
+     * \brief Stores the blocks of a section.
+     * \param blocks The blocks of the section, indexed by Geometry::GetSectionFlatIndex.
+     * \return The root of the section, which must be released once it is no longer needed.
+     */
+    [[nodiscard]] NodeRef Insert(std::span<const uint8_t> blocks);
+
+    /**
+     * \brief Decodes a section stored in the DAG.
+     * \param root The root returned by Insert.
+     * \param blocks The array to write to, indexed by Geometry::GetSectionFlatIndex. Must be SectionSize long.
+     */
+    void Expand(NodeRef root, std::span<uint8_t> blocks) const noexcept;
+
+    /**
+     * \brief Decodes the blocks of a section within a box, the other blocks are left untouched. Subtrees outside of
+     * the box are skipped, so a single face costs a fraction of expanding the whole section.
+     * \param root The root returned by Insert.
+     * \param min The lowest corner of the box, inclusive.
+     * \param max The highest corner of the box, inclusive.
+     * \param blocks The array to write to, indexed by Geometry::GetSectionFlatIndex. Must be SectionSize long.
+     */
+    void ExpandRegion(NodeRef root, std::array<int, 3> min, std::array<int, 3> max,
+                      std::span<uint8_t> blocks) const noexcept;
+
+    /**
+     * \brief Releases a section. Nodes that are no longer used by any section are freed.
+     */
+    void Release(NodeRef root) noexcept;
+
+    [[nodiscard]] size_t GetNodeCount() const noexcept;
+
+    /**
+     * \brief The number of bytes used by the nodes and the deduplication table.
+     */
+    [[nodiscard]] size_t GetMemoryUsage() const noexcept;
+
+    /**
+     * \brief The number of bytes of the nodes that are in use. Released nodes are reused by later inserts, so this is
+     * the memory the archived sections occupy, while GetMemoryUsage never shrinks.
+     */
+    [[nodiscard]] size_t GetUsedMemory() const noexcept;
+
+    [[nodiscard]] static constexpr bool IsUniform(NodeRef ref) noexcept;
+
+private:
+    using Children = std::array<NodeRef, 8>;
+
+    struct Node
+    {
+        Children children;
+        uint32_t refCount;
+    };
+
+    // Marks an unused slot of the deduplication table. Never a valid node index.
+    static constexpr NodeRef EmptySlot = UniformFlag;
+
+    std::vector<Node> nodes_{};
+    std::vector<NodeRef> freeNodes_{};
+
+    // Open addressing hash set of all nodes, keyed by their children. Only stores the node index
+    // so the children are not stored a second time.
+    std::vector<NodeRef> table_{};
+    size_t tableCount_{0};
+
+    [[nodiscard]] NodeRef Build(std::span<const uint8_t> blocks, int x, int y, int z, int size);
+    [[nodiscard]] NodeRef Share(const Children& children);
+    void ExpandNode(NodeRef ref, std::span<uint8_t> blocks, int x, int y, int z, int size) const noexcept;
+    void ExpandRegionNode(NodeRef ref, const std::array<int, 3>& min, const std::array<int, 3>& max,
+                          std::span<uint8_t> blocks, int x, int y, int z, int size) const noexcept;
+
+    [[nodiscard]] static size_t Hash(const Children& children) noexcept;
+    [[nodiscard]] NodeRef Find(const Children& children) const noexcept;
+    void TableInsert(NodeRef ref);
+    void TableErase(NodeRef ref) noexcept;
+};
+
+constexpr bool Blocks::VoxelDag::IsUniform(const NodeRef ref) noexcept
+{
+    return (ref & UniformFlag) != 0;
+}
@@ -8,7 +8,9 @@
 // File: World.h
 
 #pragma once
+#include <array>
 #include <cstdint>
+#include <list>
 #include <mutex>
 #include <queue>
 #include <unordered_map>
@@ -16,6 +18,7 @@
 #include <boost/container_hash/hash.hpp>
 #include <FastNoise/FastNoise.h>
 
+#include "BlockPatch.h"
 #include "Chunk.h"
 #include "LoadingScreen.h"
 #include "BlocksEngine/Core/Transform.h"
@@ -30,13 +33,29 @@ namespace Blocks
 class Blocks::World final : public BlocksEngine::Component
 {
 public:
-    using ChunkHash = boost::hash<BlocksEngine::Vector2<int>>;
+    using ChunkHash = boost::hash<BlocksEngine::Vector3<int>>;
 
     //------------------------------------------------------------------------------
     // Constructors
     //------------------------------------------------------------------------------
 
-    World(std::weak_ptr<BlocksEngine::Transform> playerTransform, uint8_t chunkLoadDistance = 8);
+    /**
+     * \param playerTransform The transform around which chunks are loaded.
+     * \param chunkLoadDistance The radius in chunks of the circle around the player in which chunks are loaded.
+     * \param verticalViewDistance The number of chunks above and below the chunk of the player that are loaded.
+     * \param mesher The strategy used to mesh all sections, the binary mesher if nullptr.
+     * \param detailDistance The distance in chunks up to which chunks are meshed at the full resolution. Every further
+     * level of detail starts at twice the distance of the previous one.
+     * \param maxResidentChunks The number of chunks kept loaded, including the ones outside of the view distance.
+     * \param maxResidentBytes The number of bytes the blocks, meshes and archive of all loaded chunks may occupy.
+     * Chunks outside of the view distance are evicted once either budget is exceeded, the chunks in view never are.
+     * \param maxEvictedBytes The number of bytes the archived blocks of evicted chunks that were edited may occupy.
+     * They can not be generated again, so once this cap is reached edited chunks stay loaded instead of being evicted.
+     */
+    World(std::weak_ptr<BlocksEngine::Transform> playerTransform, uint8_t chunkLoadDistance = 8,
+          uint8_t verticalViewDistance = 4, std::shared_ptr<const Chunk::SectionMesher> mesher = nullptr,
+          uint8_t detailDistance = 4, size_t maxResidentChunks = 4096, size_t maxResidentBytes = 256 * 1024 * 1024,
+          size_t maxEvictedBytes = 64 * 1024 * 1024);
 
     //------------------------------------------------------------------------------
     // Engine Events
@@ -52,21 +71,203 @@ public:
     [[nodiscard]]
     Chunk::ChunkCoords ChunkCoordFromPosition(const BlocksEngine::Vector3<float>& position) const noexcept;
 
+    [[nodiscard]]
+    Chunk::ChunkCoords ChunkCoordFromPosition(BlocksEngine::Vector3<int> position) const noexcept;
+
+    [[nodiscard]]
+    Chunk::SectionCoords SectionCoordFromPosition(const BlocksEngine::Vector3<float>& position) const noexcept;
+
+    [[nodiscard]]
+    Chunk::SectionCoords SectionCoordFromPosition(BlocksEngine::Vector3<int> position) const noexcept;
+
     [[nodiscard]]
     const Block& GetBlock(BlocksEngine::Vector3<int> position) const noexcept;
 
+    /**
+     * \brief The strategy every section of this world is meshed with. Can be shared with mesh workers.
+     */
+    [[nodiscard]]
+    std::shared_ptr<const Chunk::SectionMesher> GetMesher() const noexcept;
+
+    /**
+     * \brief The height above the highest non air block at the given world column, e.g. to place the player on.
+     * The loaded chunks of the column above and below the player are searched from the top down.
+     * \return The y coordinate of the first block above the surface, 0 if the column is not loaded or empty.
+     */
+    [[nodiscard]]
+    int GetSurfaceHeight(int x, int z) const noexcept;
+
+    /**
+     * \brief Replaces a single block. Must be called on the main thread.
+     * The meshes of the section of the block and the sections it touches are patched right away. Sections that can
+     * not be patched are remeshed once at the next update, no matter how many of their blocks changed in between.
+     * \param position The world position of the block.
+     * \param block The new block.
+     * \return False if the chunk of the block is not loaded or the block did not change.
+     */
+    bool SetBlock(BlocksEngine::Vector3<int> position, const Block& block);
+
+    /**
+     * \brief The number of bytes of the archived blocks of evicted chunks that were edited. Not part of the residency
+     * budget, limited by maxEvictedBytes instead.
+     */
+    [[nodiscard]]
+    size_t GetEvictedMemoryUsage() const noexcept;
+
+    /**
+     * \brief The number of bytes the loaded chunks and the archive count against maxResidentBytes.
+     */
+    [[nodiscard]]
+    size_t GetResidentMemoryUsage() const noexcept;
+
+    //------------------------------------------------------------------------------
+    // Memory Accounting
+    //
+    // The loaded chunks report every change to the memory they use, so the residency budget is checked without
+    // visiting every chunk. Must be called on the main thread.
+    //------------------------------------------------------------------------------
+
+    /**
+     * \brief Replaces the number of bytes counted for the blocks and colliders of a chunk or section.
+     * \param previous The number of bytes reported before, 0 for a new chunk or section.
+     * \param current The number of bytes used now, 0 once the chunk or section is destroyed.
+     */
+    void UpdateResidentMemory(size_t previous, size_t current) noexcept;
+
+    /**
+     * \brief Counts a vertex buffer shown by one more section. A buffer shared by several sections through the mesh
+     * cache is only counted once.
+     * \param buffer The vertex buffer of the section.
+     * \param bytes The size of the buffer, only counted when it is shown for the first time.
+     */
+    void AddMeshUser(const BlocksEngine::VertexBuffer* buffer, size_t bytes);
+
+    /**
+     * \brief Stops counting a vertex buffer for a section. The buffer is no longer counted once no section shows it.
+     */
+    void RemoveMeshUser(const BlocksEngine::VertexBuffer* buffer) noexcept;
+
+    //------------------------------------------------------------------------------
+    // Bulk Edits
+    //
+    // Every bulk edit is applied as a single transaction: each touched section is decoded and written once and
+    // is remeshed, including its collider, once at the next update. Blocks in chunks that are not loaded are skipped.
+    //------------------------------------------------------------------------------
+
+    /**
+     * \brief Sets every block in a box to the same block.
+     * \param min The inclusive lower corner of the box in world coordinates.
+     * \param max The inclusive upper corner of the box in world coordinates.
+     * \param block The block to fill the box with.
+     */
+    void FillRegion(BlocksEngine::Vector3<int> min, BlocksEngine::Vector3<int> max, const Block& block);
+
+    /**
+     * \brief Replaces every occurrence of a block in a box with another block.
+     * \param min The inclusive lower corner of the box in world coordinates.
+     * \param max The inclusive upper corner of the box in world coordinates.
+     * \param from The block to replace.
+     * \param to The block to replace it with.
+     */
+    void ReplaceInRegion(BlocksEngine::Vector3<int> min, BlocksEngine::Vector3<int> max, const Block& from,
+                         const Block& to);
+
+    /**
+     * \brief Pastes a patch into the world. Blocks of the patch with the id BlockPatch::Keep are left unchanged.
+     * \param origin The world position of the lower corner of the patch.
+     * \param patch The blocks to paste.
+     */
+    void ApplyPatch(BlocksEngine::Vector3<int> origin, const BlockPatch& patch);
+
     void SetPlayerTransform(std::shared_ptr<BlocksEngine::Transform> playerTransform) noexcept;
 
+    /**
+     * \brief Generates all blocks for the chunk at the given coordinates.
+     * Does not depend on any world state and can therefore be called from any thread.
+     * \param coords The coordinates of the chunk to generate. The terrain continues below the lowest chunk, so any
+     * chunk can be generated.
+     * \return A list of all blocks in the chunk
+     
+     * TODO: This is the main chunk generation that needs to be implemented @Sevi
+     */
+    [[nodiscard]] static Chunk::ChunkData GenerateChunk(Chunk::ChunkCoords coords);
+
 private:
     std::mutex genLock_;
     std::mutex meshLock_;
 
-    // TODO: This is currently not a radius but just a square where the value is 2x in every x and y directions.
+    // Chunks are only unloaded once they are this many chunks beyond the view distance, so walking back and forth
+    // along the border of a chunk does not load and unload the same ring of chunks over and over
+    static constexpr int ViewHysteresis = 1;
+
+    /**
+     * \brief The chunks affected by the player moving into one of the 26 chunks around the previous one.
+     */
+    struct MoveOffsets
+    {
+        // The chunks that come into view, relative to the new chunk of the player and in the order of viewOffsets_
+        std::vector<Chunk::ChunkCoords> entering;
+
+        // The chunks that fall beyond the view distance and its hysteresis, relative to the previous chunk of the
+        // player. Only the ones that are still active have to be archived.
+        std::vector<Chunk::ChunkCoords> leaving;
+
+        // The chunks that stay within the hysteresis but cross the edge of a level of detail band, relative to the new
+        // chunk of the player
+        std::vector<Chunk::ChunkCoords> levelChanges;
+    };
+
     // The view radius distance
     uint8_t chunkViewDistance_;
+    uint8_t verticalViewDistance_;
+    uint8_t detailDistance_;
+    std::shared_ptr<const Chunk::SectionMesher> mesher_;
     std::unordered_map<Chunk::ChunkCoords, std::shared_ptr<Chunk>, ChunkHash> chunks_{};
     std::unordered_set<Chunk::ChunkCoords, ChunkHash> activeChunkCoords_{};
 
+    // The offsets of all chunks in view from the chunk of the player, spiralling outwards so close chunks load first.
+    // Every layer of the horizontal circle is repeated for each chunk above and below the player.
+    std::vector<Chunk::ChunkCoords> viewOffsets_{};
+
+    // The offsets to revisit for every step of the player into a neighbouring chunk, indexed by GetMoveIndex
+    std::array<MoveOffsets, 27> moveOffsets_{};
+
+    // Holds the blocks of the chunks outside of the view distance, identical subtrees are shared between chunks
+    VoxelDag archive_{};
+
+    // Chunks with at least one section that has to be remeshed at the next update
+    std::vector<std::shared_ptr<Chunk>> dirtyChunks_{};
+
+    size_t maxResidentChunks_;
+    size_t maxResidentBytes_;
+    size_t maxEvictedBytes_;
+
+    // Whether edited chunks are kept loaded as the evicted archive reached its cap, only reported once it is reached
+    bool isEvictedArchiveFull_{false};
+
+    /**
+     * \brief The size of a vertex buffer and the number of sections showing it.
+     */
+    struct MeshUsage
+    {
+        size_t bytes;
+        size_t users;
+    };
+
+    // The bytes of the blocks, meshes and colliders of all loaded chunks, kept up to date by the chunks themselves.
+    // The archive is measured separately.
+    size_t residentBytes_{0};
+    std::unordered_map<const BlocksEngine::VertexBuffer*, MeshUsage> meshUsages_{};
+
+    // The loaded chunks outside of the view distance, the least recently visible one first
+    std::list<Chunk::ChunkCoords> inactiveChunks_{};
+    std::unordered_map<Chunk::ChunkCoords, std::list<Chunk::ChunkCoords>::iterator, ChunkHash> inactivePositions_{};
+
+    // The archived blocks of evicted chunks that were edited and can not be generated again. They are kept in their
+    // own DAG, so the residency budget only measures the loaded chunks.
+    VoxelDag evictedArchive_{};
+    std::unordered_map<Chunk::ChunkCoords, Chunk::ArchiveRoots, ChunkHash> evictedChunks_{};
+
     // These are probably temporary variables. They track where the player is and whether chunks need to be updated.
     std::weak_ptr<BlocksEngine::Transform> playerTransform_;
     Chunk::ChunkCoords lastChunkCoords_{Chunk::ChunkCoords::Zero};
@@ -93,31 +294,115 @@ private:
     std::shared_ptr<Chunk> CreateChunk(Chunk::ChunkCoords coords);
 
     /**
-     * \brief Generates all blocks for a given chunk and initializes said chunk.
-     * \param chunk The uninitialized Chunk to be initialized.
-     * \return A list of all blocks in the chunk
-     
-     * TODO: This is the main chunk generation that needs to be implemented @Sevi
+     * \brief Creates a chunk that was evicted after it had been edited and assigns its archived blocks.
+     * \return Nullptr if the chunk was not edited and has to be generated instead.
+     */
+    std::shared_ptr<Chunk> ReloadChunk(Chunk::ChunkCoords coords);
+
+    /**
+     * \brief Frees chunks outside of the view distance, least recently visible first, until both residency budgets
+     * are met. The meshes and colliders of chunks are released first, the blocks and actors only once that is not
+     * enough. Chunks with pending mesh jobs are kept until the next update, edited chunks while the evicted archive
+     * is full.
+     */
+    void EvictChunks();
+
+    /**
+     * \brief Unlinks an archived chunk from its neighbours and destroys it. The blocks of edited chunks are moved to
+     * the evicted archive until the chunk is loaded again.
      */
-    [[nodiscard]] Chunk::ChunkData GenerateChunk(std::shared_ptr<Chunk> chunk) const;
+    void EvictChunk(Chunk::ChunkCoords coords);
 
     void OnWorldGenerated();
 
+    /**
+     * \brief Whether a chunk lies within a cylinder of chunks: a circle on the horizontal plane, measured between the
+     * centers of the chunks, stacked as many chunks above and below the center.
+     * \param coords The coordinates of the chunk.
+     * \param center The coordinates of the chunk in the center of the cylinder.
+     * \param radius The radius of the circle in chunks.
+     * \param verticalRadius The number of chunks above and below the center.
+     */
+    [[nodiscard]] static bool IsWithinView(Chunk::ChunkCoords coords, Chunk::ChunkCoords center, int radius,
+                                           int verticalRadius) noexcept;
+
+    /**
+     * \brief The index into moveOffsets_ of a step of the player.
+     * \param move The difference between the new and the previous chunk of the player, at most 1 along every axis.
+     */
+    [[nodiscard]] static size_t GetMoveIndex(Chunk::ChunkCoords move) noexcept;
+
+    /**
+     * \brief The level of detail of a chunk, chosen from its horizontal distance to the chunk of the player.
+     * \param coords The coordinates of the chunk.
+     * \param center The coordinates of the chunk the player is in.
+     */
+    [[nodiscard]] int GetLevelOfDetail(Chunk::ChunkCoords coords, Chunk::ChunkCoords center) const noexcept;
+
+    /**
+     * \brief Changes the level of detail of a chunk and marks it and the chunks next to it dirty, as the faces
+     * along their shared borders are meshed from the cells of both levels.
+     */
+    void SetLevelOfDetail(const std::shared_ptr<Chunk>& chunk, int level);
+
+    /**
+     * \brief Marks every section of a chunk to be remeshed. Does nothing if the chunk is not loaded or its blocks
+     * have not been generated yet.
+     */
+    void MarkChunkDirty(Chunk::ChunkCoords coords);
+
+    /**
+     * \brief Marks the section containing the given block to be remeshed. Does nothing if the chunk is not loaded.
+     */
+    void MarkSectionDirty(BlocksEngine::Vector3<int> position);
+
+    /**
+     * \brief Patches the mesh of a section after a single block changed, or marks the section dirty if that fails.
+     * \param section The world position of any block in the section.
+     * \param position The world position of the changed block.
+     */
+    void PatchSection(BlocksEngine::Vector3<int> section, BlocksEngine::Vector3<int> position);
+
+    /**
+     * \brief Patches the section of a changed block and every neighbouring section that shares a face with it.
+     */
+    void PatchBlock(BlocksEngine::Vector3<int> position);
+
+    /**
+     * \brief Dispatches a single mesh job for every dirty section.
+     */
+    void RemeshDirtySections();
+
+    /**
+     * \brief Splits a box into the sections it overlaps and passes each of them to Chunk::EditSection.
+     * Changed sections and the sections they share a face with are marked dirty.
+     * \param min The inclusive lower corner of the box in world coordinates.
+     * \param max The inclusive upper corner of the box in world coordinates.
+     * \param edit The edit applied to every row of the box.
+     */
+    void EditRegion(BlocksEngine::Vector3<int> min, BlocksEngine::Vector3<int> max, const Chunk::RowEdit& edit);
+
     void OnWorldLoaded() const;
 
     /**
      * \brief A chunk generation request is a Dispatch Work Item that is responsible for calling GenerateChunk
-     * and assigning the result on the main thread to the chunk
+     * and assigning the result on the main thread to the chunk. A chunk that left the view distance in the meantime is
+     * archived right away.
      * \param chunk The chunk to generate the blocks for
      * \return A DispatchWorkItem that generates a chunk once executed.
      */
     [[nodiscard]] std::shared_ptr<BlocksEngine::DispatchWorkItem> CreateGenerationRequestForChunk(
-        std::shared_ptr<Chunk> chunk) const;
+        std::shared_ptr<Chunk> chunk);
 
     [[nodiscard]] std::shared_ptr<BlocksEngine::DispatchWorkGroup> CreateMeshRequestGroup(
         std::vector<std::shared_ptr<Chunk>> chunks) const;
 
 
+    /**
+     * \brief Loads the chunks that entered the view distance after the player moved to another chunk, closest first,
+     * and archives the chunks that left it. Steps into a neighbouring chunk only visit the precomputed moveOffsets_,
+     * longer jumps scan every active chunk and the whole view.
+     */
     void UpdateChunks();
 
 
@@ -0,0 +1,32 @@
+﻿#include "Blocks/pch.h"
+#include "Blocks/Benchmark/Benchmark.h"
+
+#include <boost/log/trivial.hpp>
+
+#include "Blocks/World/World.h"
+
+int Blocks::Benchmark::RunAll()
+{
+    BOOST_LOG_TRIVIAL(info) << "Running benchmarks";
+
+    RunBlockStorage();
+    RunChunkLayout();
+    RunVoxelDag();
+    RunMeshing();
+
+    BOOST_LOG_TRIVIAL(info) << "Benchmarks finished";
+    return 0;
+}
+
+std::vector<uint8_t> Blocks::Benchmark::GenerateColumn(const int x, const int z)
+{
+    // Sections are contiguous and laid out the same in a chunk and in a column, so the chunks are simply appended
+    std::vector<uint8_t> column;
+    column.reserve(ColumnGeometry::Size);
+    for (int y = 0; y < ColumnGeometry::Height / Chunk::Height; ++y)
+    {
+        const Chunk::ChunkData blocks = World::GenerateChunk({x, y, z});
+        column.insert(column.end(), blocks.begin(), blocks.end());
+    }
+    return column;
+}
@@ -0,0 +1,138 @@
+﻿#include "Blocks/pch.h"
+#include "Blocks/Benchmark/Benchmark.h"
+
+#include <random>
+#include <boost/log/trivial.hpp>
+
+#include "Blocks/World/BlockRegistry.h"
+#include "Blocks/World/Chunk.h"
+#include "Blocks/World/World.h"
+
+using namespace Blocks;
+using namespace BlocksEngine;
+
+void Benchmark::RunBlockStorage()
+{
+    constexpr int chunkRadius = 4;
+    constexpr int lookups = 1 << 20;
+
+    std::vector<Chunk::ChunkData> flatChunks;
+    std::vector<Chunk::SectionData> chunks;
+
+    for (int x = -chunkRadius; x < chunkRadius; ++x)
+    {
+        for (int z = -chunkRadius; z < chunkRadius; ++z)
+        {
+            for (int y = 0; y < ColumnGeometry::Height / Chunk::Height; ++y)
+            {
+                flatChunks.push_back(World::GenerateChunk({x, y, z}));
+                chunks.push_back(Chunk::SplitIntoSections(flatChunks.back()));
+            }
+        }
+    }
+
+    size_t flatMemory = 0;
+    size_t paletteMemory = 0;
+    size_t emptySections = 0;
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        flatMemory += flatChunks[i].capacity() * sizeof(uint8_t);
+        for (const auto& section : chunks[i])
+        {
+            paletteMemory += sizeof(section);
+            if (section)
+            {
+                paletteMemory += section->GetMemoryUsage();
+            }
+            else
+            {
+                ++emptySections;
+            }
+        }
+    }
+
+    // Mirrors Chunk::ChunkSection::GetBlockId
+    const auto getBlockId = [](const Chunk::SectionData& sections, const Vector3<int> position)
+    {
+        const auto& section = sections[Chunk::Geometry::GetSection(position.y)];
+        return section ? section->Get(Chunk::GetSectionFlatIndex(position)) : Block::Air.GetId();
+    };
+
+    // Pre compute the lookups so the random number generator is not part of the measurement.
+    std::mt19937 random{1337};
+    std::uniform_int_distribution<size_t> chunkDistribution{0, chunks.size() - 1};
+    std::uniform_int_distribution widthDistribution{0, Chunk::Width - 1};
+    std::uniform_int_distribution heightDistribution{0, Chunk::Height - 1};
+    std::uniform_int_distribution depthDistribution{0, Chunk::Depth - 1};
+
+    std::vector<std::pair<size_t, Vector3<int>>> positions(lookups);
+    for (auto& [chunk, position] : positions)
+    {
+        chunk = chunkDistribution(random);
+        position = {widthDistribution(random), heightDistribution(random), depthDistribution(random)};
+    }
+
+    const double flatRandom = Measure([&]
+    {
+        uint64_t sum = 0;
+        for (const auto& [chunk, position] : positions)
+        {
+            sum += BlockRegistry::GetBlock(flatChunks[chunk][Chunk::GetFlatIndex(position)]).GetId();
+        }
+        Sink = sum;
+    }, 10) / lookups;
+
+    const double paletteRandom = Measure([&]
+    {
+        uint64_t sum = 0;
+        for (const auto& [chunk, position] : positions)
+        {
+            sum += BlockRegistry::GetBlock(getBlockId(chunks[chunk], position)).GetId();
+        }
+        Sink = sum;
+    }, 10) / lookups;
+
+    const double blocksPerScan = static_cast<double>(chunks.size()) * Chunk::Size;
+
+    const double flatScan = Measure([&]
+    {
+        uint64_t sum = 0;
+        for (const auto& blocks : flatChunks)
+        {
+            for (const uint8_t block : blocks)
+            {
+                sum += block;
+            }
+        }
+        Sink = sum;
+    }, 10) / blocksPerScan;
+
+    std::vector<uint8_t> decoded(Chunk::SectionSize);
+    const double paletteScan = Measure([&]
+    {
+        uint64_t sum = 0;
+        for (const auto& chunk : chunks)
+        {
+            for (const auto& section : chunk)
+            {
+                if (!section) continue;
+
+                section->CopyTo(decoded);
+                for (const uint8_t block : decoded)
+                {
+                    sum += block;
+                }
+            }
+        }
+        Sink = sum;
+    }, 10) / blocksPerScan;
+
+    BOOST_LOG_TRIVIAL(info) << "BlockStorage: " << chunks.size() << " chunks, " << emptySections
+        << " empty sections";
+    BOOST_LOG_TRIVIAL(info) << "BlockStorage: memory flat " << flatMemory << " B, palette " << paletteMemory
+        << " B (" << static_cast<double>(flatMemory) / static_cast<double>(paletteMemory) << "x smaller)";
+    BOOST_LOG_TRIVIAL(info) << "BlockStorage: random access flat " << flatRandom << " ns, palette " << paletteRandom
+        << " ns per block";
+    BOOST_LOG_TRIVIAL(info) << "BlockStorage: sequential scan flat " << flatScan << " ns, palette " << paletteScan
+        << " ns per block";
+}
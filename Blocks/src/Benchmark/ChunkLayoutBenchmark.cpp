@@ -0,0 +1,110 @@
+﻿#include "Blocks/pch.h"
+#include "Blocks/Benchmark/Benchmark.h"
+
+#include <boost/log/trivial.hpp>
+
+#include "Blocks/World/Chunk.h"
+#include "Blocks/World/ChunkGeometry.h"
+#include "Blocks/World/World.h"
+#include "Blocks/World/Meshing/GreedyMesher.h"
+
+using namespace Blocks;
+
+namespace
+{
+    template <class Layout>
+    void RunLayout(const char* name, const std::vector<std::vector<uint8_t>>& generatedChunks)
+    {
+        using Geometry = ChunkGeometry<4, 4, 4, Benchmark::ColumnGeometry::SectionsPerChunk, Layout>;
+
+        // Reorder the generated blocks into the layout being measured
+        std::vector<std::vector<uint8_t>> chunks;
+        for (const auto& generated : generatedChunks)
+        {
+            std::vector<uint8_t>& blocks = chunks.emplace_back(Geometry::Size);
+            for (int y = 0; y < Geometry::Height; ++y)
+            {
+                for (int z = 0; z < Geometry::Depth; ++z)
+                {
+                    for (int x = 0; x < Geometry::Width; ++x)
+                    {
+                        blocks[Geometry::GetFlatIndex(x, y, z)] =
+                            generated[Benchmark::ColumnGeometry::GetFlatIndex(x, y, z)];
+                    }
+                }
+            }
+        }
+
+        // Counts the solid neighbours of every block, as done by lighting and face culling.
+        // The top and bottom layer are skipped so no query leaves the chunk, x and z wrap around.
+        const double neighbourQuery = Benchmark::Measure([&]
+        {
+            uint64_t sum = 0;
+            for (const auto& blocks : chunks)
+            {
+                for (int y = 1; y < Geometry::Height - 1; ++y)
+                {
+                    for (int z = 0; z < Geometry::Depth; ++z)
+                    {
+                        for (int x = 0; x < Geometry::Width; ++x)
+                        {
+                            sum += (blocks[Geometry::GetFlatIndex(x - 1, y, z)] != 0)
+                                + (blocks[Geometry::GetFlatIndex(x + 1, y, z)] != 0)
+                                + (blocks[Geometry::GetFlatIndex(x, y - 1, z)] != 0)
+                                + (blocks[Geometry::GetFlatIndex(x, y + 1, z)] != 0)
+                                + (blocks[Geometry::GetFlatIndex(x, y, z - 1)] != 0)
+                                + (blocks[Geometry::GetFlatIndex(x, y, z + 1)] != 0);
+                        }
+                    }
+                }
+            }
+            Benchmark::Sink = sum;
+        }, 10) / (static_cast<double>(chunks.size()) * Geometry::Width * Geometry::Depth * (Geometry::Height - 2));
+
+        const double mesher = Benchmark::Measure([&]
+        {
+            uint64_t quads = 0;
+            for (const auto& blocks : chunks)
+            {
+                for (int section = 0; section < Geometry::SectionsPerChunk; ++section)
+                {
+                    const ChunkMeshData meshData = GreedyMesher<Geometry>::Generate(
+                        [&blocks, section](const int x, const int y, const int z) -> uint8_t
+                        {
+                            const int chunkY = y + section * Geometry::SectionHeight;
+                            if (x < 0 || x >= Geometry::Width || z < 0 || z >= Geometry::Depth
+                                || chunkY < 0 || chunkY >= Geometry::Height)
+                            {
+                                return 0;
+                            }
+                            return blocks[Geometry::GetFlatIndex(x, chunkY, z)];
+                        });
+                    quads += meshData.GetQuadCount();
+                }
+            }
+            Benchmark::Sink = quads;
+        }, 5) / (static_cast<double>(chunks.size()) * Geometry::SectionsPerChunk);
+
+        BOOST_LOG_TRIVIAL(info) << "ChunkLayout " << name << ": neighbour query " << neighbourQuery
+            << " ns per block, greedy mesher " << mesher / 1000.0 << " us per section";
+    }
+}
+
+void Benchmark::RunChunkLayout()
+{
+    constexpr int chunkRadius = 2;
+
+    // Every layout is measured on columns of chunks, which contain the whole surface
+    std::vector<std::vector<uint8_t>> chunks;
+    for (int x = -chunkRadius; x < chunkRadius; ++x)
+    {
+        for (int z = -chunkRadius; z < chunkRadius; ++z)
+        {
+            chunks.push_back(GenerateColumn(x, z));
+        }
+    }
+
+    RunLayout<LinearLayout>("linear", chunks);
+    RunLayout<MortonLayout>("morton", chunks);
+    RunLayout<TiledLayout>("tiled", chunks);
+}
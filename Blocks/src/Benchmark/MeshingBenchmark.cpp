@@ -0,0 +1,706 @@
+﻿#include "Blocks/pch.h"
+#include "Blocks/Benchmark/Benchmark.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <boost/log/trivial.hpp>
+
+#include "Blocks/World/Block.h"
+#include "Blocks/World/BoxDecomposition.h"
+#include "Blocks/World/Chunk.h"
+#include "Blocks/World/World.h"
+#include "Blocks/World/Meshing/LevelOfDetail.h"
+#include "Blocks/World/Meshing/Meshers.h"
+#include "Blocks/World/Meshing/SectionQuads.h"
+#include "BlocksEngine/Graphics/Mesh/IndexBuffer.h"
+#include "BlocksEngine/Graphics/Mesh/VertexCache.h"
+
+using namespace Blocks;
+
+namespace
+{
+    using Geometry = Chunk::Geometry;
+
+    /**
+     * \brief Splits every quad of a mesh into the block faces it covers.
+     * Two meshes cover the same visible surface if they produce the same faces, no matter how the faces were merged.
+     * \return One key per block face containing its axis, direction, position and texture, sorted.
+     */
+    std::vector<uint64_t> GetSurface(const ChunkMeshData& meshData)
+    {
+        std::vector<uint64_t> faces;
+
+        // Every mesher emits quads as four vertices through ChunkMeshData::AddQuad
+        for (size_t quad = 0; quad < meshData.GetQuadCount(); ++quad)
+        {
+            const BlocksEngine::TerrainVertex* vertices = &meshData.vertices[quad * 4];
+
+            const auto getPosition = [vertices](const int vertex)
+            {
+                const BlocksEngine::TerrainVertex& v = vertices[vertex];
+                return std::array<int, 3>{
+                    static_cast<int>(v.GetX()), static_cast<int>(v.GetY()), static_cast<int>(v.GetZ())
+                };
+            };
+
+            std::array<int, 3> min = getPosition(0);
+            std::array<int, 3> max = min;
+            for (int vertex = 1; vertex < 4; ++vertex)
+            {
+                const std::array<int, 3> position = getPosition(vertex);
+                for (int i = 0; i < 3; ++i)
+                {
+                    min[i] = std::min(min[i], position[i]);
+                    max[i] = std::max(max[i], position[i]);
+                }
+            }
+
+            const int axis = min[0] == max[0] ? 0 : min[1] == max[1] ? 1 : 2;
+            const int u = (axis + 1) % 3;
+            const int v = (axis + 2) % 3;
+
+            // The winding of the first triangle (0, 1, 2) of the shared quad list tells whether the quad faces
+            // towards the positive or negative axis
+            const std::array<int, 3> p0 = getPosition(0);
+            const std::array<int, 3> p1 = getPosition(1);
+            const std::array<int, 3> p2 = getPosition(2);
+            const int normal = (p1[u] - p0[u]) * (p2[v] - p0[v]) - (p1[v] - p0[v]) * (p2[u] - p0[u]);
+
+            for (int i = min[u]; i < max[u]; ++i)
+            {
+                for (int j = min[v]; j < max[v]; ++j)
+                {
+                    faces.push_back(static_cast<uint64_t>(axis)
+                        | static_cast<uint64_t>(normal > 0) << 2
+                        | static_cast<uint64_t>(min[axis] + 1) << 8
+                        | static_cast<uint64_t>(i + 1) << 16
+                        | static_cast<uint64_t>(j + 1) << 24
+                        | static_cast<uint64_t>(vertices[0].GetTexture()) << 32);
+                }
+            }
+        }
+
+        std::ranges::sort(faces);
+        return faces;
+    }
+
+    /**
+     * \brief Toggles random blocks of every section and compares patching the quads against meshing it again.
+     */
+    void RunPatching(std::vector<PaddedVolume<Geometry>> volumes)
+    {
+        constexpr int editsPerSection = 32;
+
+        const BinaryMesher<Geometry> mesher;
+        const std::vector<MeshQuad>& generatedQuads = MeshScratch<Geometry>::ForCurrentThread().quads;
+
+        std::mt19937 random{1337};
+        std::uniform_int_distribution<int> xDistribution{0, Geometry::Width - 1};
+        std::uniform_int_distribution<int> yDistribution{0, Geometry::SectionHeight - 1};
+        std::uniform_int_distribution<int> zDistribution{0, Geometry::Depth - 1};
+
+        double patchDuration = 0.0;
+        double remeshDuration = 0.0;
+        size_t patches = 0;
+        size_t rebuilds = 0;
+        size_t mismatches = 0;
+
+        ChunkMeshData meshData;
+        ChunkMeshData patchedData;
+
+        for (PaddedVolume<Geometry>& volume : volumes)
+        {
+            SectionQuads<Geometry> quads;
+            mesher.Generate(volume, meshData);
+            quads.Reset(generatedQuads);
+
+            for (int edit = 0; edit < editsPerSection; ++edit)
+            {
+                const int x = xDistribution(random);
+                const int y = yDistribution(random);
+                const int z = zDistribution(random);
+                volume.Set(x, y, z, volume.Get(x, y, z) ? Block::Air.GetId() : Block::Stone.GetId());
+
+                // A patch includes writing the vertices of the changed quads, like a section does before uploading
+                auto start = std::chrono::high_resolution_clock::now();
+                const bool patched = quads.PatchBlock({x, y, z}, [&volume](const int bx, const int by, const int bz)
+                {
+                    return volume.Get(bx, by, bz);
+                });
+                if (patched)
+                {
+                    patchedData.Clear();
+                    for (const uint32_t slot : quads.GetChangedSlots())
+                    {
+                        patchedData.AddQuad(quads.GetQuad(slot));
+                    }
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                patchDuration += std::chrono::duration<double, std::nano>(end - start).count();
+
+                start = std::chrono::high_resolution_clock::now();
+                mesher.Generate(volume, meshData);
+                end = std::chrono::high_resolution_clock::now();
+                remeshDuration += std::chrono::duration<double, std::nano>(end - start).count();
+
+                if (!patched)
+                {
+                    ++rebuilds;
+                    quads.Reset(generatedQuads);
+                    continue;
+                }
+
+                ++patches;
+
+                patchedData.Clear();
+                for (int group = 0; group < ChunkMeshData::GroupCount; ++group)
+                {
+                    for (const MeshQuad& quad : quads.GetQuads(group))
+                    {
+                        patchedData.AddQuad(quad);
+                    }
+                }
+                mismatches += GetSurface(patchedData) != GetSurface(meshData);
+            }
+        }
+
+        const size_t edits = volumes.size() * editsPerSection;
+        BOOST_LOG_TRIVIAL(info) << "Meshing patch: " << patchDuration / static_cast<double>(edits) / 1000.0
+            << " us per block edit, remeshing the section " << remeshDuration / static_cast<double>(edits) / 1000.0
+            << " us, " << patches << " patches, " << rebuilds << " rebuilds, " << mismatches
+            << " patches with a different surface";
+    }
+
+    size_t GetMemoryUsage(const ChunkMeshData& meshData)
+    {
+        return meshData.vertices.size() * sizeof(BlocksEngine::TerrainVertex);
+    }
+
+    /**
+     * \brief Copies the blocks of a section and the one block border around it into a padded volume.
+     * \param origin The world position of the lowest block of the section.
+     * \param getBlockId Returns the block id at a world position.
+     */
+    template <class GetBlock>
+    void CopyVolume(const std::array<int, 3>& origin, const GetBlock& getBlockId, PaddedVolume<Geometry>& volume)
+    {
+        for (int y = -1; y <= Geometry::SectionHeight; ++y)
+        {
+            for (int z = -1; z <= Geometry::Depth; ++z)
+            {
+                for (int x = -1; x <= Geometry::Width; ++x)
+                {
+                    volume.Set(x, y, z, getBlockId(origin[0] + x, origin[1] + y, origin[2] + z));
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Counts the sections that could show the cached mesh of an earlier section and compares meshing every
+     * section on its own against looking it up first, the way the mesh jobs use the MeshCache. Only the work on the
+     * CPU is measured, a cache hit also skips creating and uploading the vertex buffer.
+     * \param name The terrain the sections were taken from.
+     */
+    void RunMeshCache(const char* name, const std::vector<PaddedVolume<Geometry>>& volumes)
+    {
+        const BinaryMesher<Geometry> mesher;
+        const std::vector<MeshQuad>& generatedQuads = MeshScratch<Geometry>::ForCurrentThread().quads;
+        ChunkMeshData meshData;
+
+        // Like a mesh job that misses the cache: the quads are kept for patches and the vertices spread into the
+        // ranges of the vertex buffer
+        const auto meshSection = [&](const PaddedVolume<Geometry>& volume)
+        {
+            mesher.Generate(volume, meshData);
+            SectionQuads<Geometry> quads;
+            quads.Reset(generatedQuads);
+            quads.SpreadVertices(meshData.vertices);
+            return GetMemoryUsage(meshData);
+        };
+
+        std::unordered_multimap<uint64_t, size_t> firstSections;
+        size_t duplicates = 0;
+        size_t collisions = 0;
+        size_t bytes = 0;
+        size_t cachedBytes = 0;
+
+        for (size_t i = 0; i < volumes.size(); ++i)
+        {
+            const size_t meshBytes = meshSection(volumes[i]);
+            bytes += meshBytes;
+
+            const uint64_t hash = volumes[i].GetHash();
+            const auto [first, last] = firstSections.equal_range(hash);
+
+            const auto duplicate = std::find_if(first, last, [&volumes, i](const auto& section)
+            {
+                return volumes[section.second] == volumes[i];
+            });
+
+            if (duplicate != last)
+            {
+                ++duplicates;
+                continue;
+            }
+
+            collisions += first != last;
+            firstSections.emplace(hash, i);
+            cachedBytes += meshBytes;
+        }
+
+        const double uncachedDuration = Benchmark::Measure([&]
+        {
+            uint64_t sum = 0;
+            for (const auto& volume : volumes)
+            {
+                sum += meshSection(volume);
+            }
+            Benchmark::Sink = sum;
+        }, 20) / static_cast<double>(volumes.size());
+
+        // Sections that were meshed before only pay for the hash and the comparison of their volume
+        const double cachedDuration = Benchmark::Measure([&]
+        {
+            std::unordered_multimap<uint64_t, size_t> meshed;
+            uint64_t sum = 0;
+            for (size_t i = 0; i < volumes.size(); ++i)
+            {
+                const uint64_t hash = volumes[i].GetHash();
+                const auto [first, last] = meshed.equal_range(hash);
+                if (std::any_of(first, last, [&volumes, i](const auto& section)
+                {
+                    return volumes[section.second] == volumes[i];
+                }))
+                {
+                    continue;
+                }
+
+                sum += meshSection(volumes[i]);
+                meshed.emplace(hash, i);
+            }
+            Benchmark::Sink = sum;
+        }, 20) / static_cast<double>(volumes.size());
+
+        const double duration = Benchmark::Measure([&]
+        {
+            uint64_t hash = 0;
+            for (const auto& volume : volumes)
+            {
+                hash ^= volume.GetHash();
+            }
+            Benchmark::Sink = hash;
+        }, 5) / static_cast<double>(volumes.size());
+
+        BOOST_LOG_TRIVIAL(info) << "Meshing cache " << name << ": " << duration / 1000.0 << " us per section to hash, "
+            << duplicates << " of " << volumes.size() << " sections share the blocks of an earlier section, "
+            << collisions << " hash collisions";
+        BOOST_LOG_TRIVIAL(info) << "Meshing cache " << name << ": " << uncachedDuration / 1000.0
+            << " us per section meshing every section, " << cachedDuration / 1000.0 << " us with the cache ("
+            << uncachedDuration / cachedDuration << "x less work), mesh memory " << cachedBytes << " B instead of "
+            << bytes << " B (" << static_cast<double>(bytes) / static_cast<double>(cachedBytes) << "x less)";
+    }
+
+    /**
+     * \brief Compares the boxes of the section colliders against the triangles of the meshes they replace, in total
+     * and per section with a collider.
+     */
+    void RunColliders(const std::vector<PaddedVolume<Geometry>>& volumes)
+    {
+        const BinaryMesher<Geometry> mesher;
+        ChunkMeshData meshData;
+
+        const auto decompose = [&volumes](const size_t i, const auto& addBox)
+        {
+            BoxDecomposition<Geometry>::Decompose([&volume = volumes[i]](const int x, const int y, const int z)
+            {
+                return volume.Get(x, y, z);
+            }, addBox);
+        };
+
+        size_t boxes = 0;
+        size_t triangles = 0;
+
+        // Sections without solid blocks have neither a collider nor triangles
+        size_t solidSections = 0;
+        size_t maxBoxes = 0;
+        size_t maxTriangles = 0;
+        size_t sectionsWithMoreBoxes = 0;
+
+        for (size_t i = 0; i < volumes.size(); ++i)
+        {
+            size_t sectionBoxes = 0;
+            decompose(i, [&sectionBoxes](std::array<int, 3>, std::array<int, 3>) { ++sectionBoxes; });
+            mesher.Generate(volumes[i], meshData);
+            const size_t sectionTriangles = meshData.GetQuadCount() * 2;
+
+            boxes += sectionBoxes;
+            triangles += sectionTriangles;
+            if (sectionBoxes == 0) continue;
+
+            ++solidSections;
+            maxBoxes = std::max(maxBoxes, sectionBoxes);
+            maxTriangles = std::max(maxTriangles, sectionTriangles);
+            sectionsWithMoreBoxes += sectionBoxes > sectionTriangles;
+        }
+
+        const double duration = Benchmark::Measure([&]
+        {
+            uint64_t covered = 0;
+            for (size_t i = 0; i < volumes.size(); ++i)
+            {
+                decompose(i, [&covered](const std::array<int, 3> min, const std::array<int, 3> max)
+                {
+                    covered += (max[0] - min[0]) * (max[1] - min[1]) * (max[2] - min[2]);
+                });
+            }
+            Benchmark::Sink = covered;
+        }, 5) / static_cast<double>(volumes.size());
+
+        const double sections = static_cast<double>(std::max<size_t>(solidSections, 1));
+
+        BOOST_LOG_TRIVIAL(info) << "Meshing colliders: " << duration / 1000.0 << " us per section to decompose, "
+            << boxes << " boxes instead of " << triangles << " triangles for " << volumes.size() << " sections";
+        BOOST_LOG_TRIVIAL(info) << "Meshing colliders: " << solidSections << " sections with a collider, "
+            << static_cast<double>(boxes) / sections << " boxes (at most " << maxBoxes << ") instead of "
+            << static_cast<double>(triangles) / sections << " triangles (at most " << maxTriangles
+            << ") per section, " << sectionsWithMoreBoxes << " sections with more boxes than triangles";
+    }
+
+    /**
+     * \brief Measures the vertex reuse of the section meshes on a simulated post-transform cache, before and after
+     * reordering their triangles with Tipsify. The quads of a section share no vertices, so the shared quad list sits
+     * at the analytical floor of 2 misses per triangle, four unique vertices for every two triangles, and no order can
+     * improve on it. Welding the vertices that only differ in their texture coordinates shows the reuse that deriving
+     * them in the shader would allow. Greedy quads mostly meet in T-junctions, so welding only removes part of the
+     * misses and Tipsify does not lower the welded ratio any further. This is why section meshes keep the shared quad
+     * index buffer unreordered.
+     */
+    void RunVertexCache(const std::vector<PaddedVolume<Geometry>>& volumes)
+    {
+        using BlocksEngine::VertexCache;
+
+        constexpr size_t cacheSize = 16;
+        constexpr std::array policies{VertexCache::Policy::Fifo, VertexCache::Policy::Lru};
+
+        const BinaryMesher<Geometry> mesher;
+        ChunkMeshData meshData;
+
+        // The welded triangle lists and their number of vertices
+        std::vector<std::pair<std::vector<uint32_t>, size_t>> weldedLists;
+
+        // The misses of the quad list and of the welded list, each before and after reordering, for every policy
+        std::array<std::array<double, policies.size()>, 4> misses{};
+        size_t triangles = 0;
+
+        for (const auto& volume : volumes)
+        {
+            mesher.Generate(volume, meshData);
+            const auto quadCount = static_cast<UINT>(meshData.GetQuadCount());
+            if (quadCount == 0) continue;
+
+            const std::vector<uint32_t> quadList = BlocksEngine::IndexBuffer::CreateQuadIndices<uint32_t>(quadCount);
+
+            std::unordered_map<uint64_t, uint32_t> weldedVertices;
+            std::vector<uint32_t> welded;
+            welded.reserve(quadList.size());
+            for (const uint32_t index : quadList)
+            {
+                const BlocksEngine::TerrainVertex& vertex = meshData.vertices[index];
+                const uint64_t key = vertex.GetX() | vertex.GetY() << 5 | vertex.GetZ() << 10 | vertex.GetFace() << 15
+                    | static_cast<uint64_t>(vertex.GetTexture()) << 32;
+                welded.push_back(weldedVertices.try_emplace(key, static_cast<uint32_t>(weldedVertices.size()))
+                                               .first->second);
+            }
+
+            const std::array<std::vector<uint32_t>, 4> lists{
+                quadList,
+                VertexCache::Tipsify(std::span<const uint32_t>{quadList}, meshData.vertices.size(), cacheSize),
+                welded,
+                VertexCache::Tipsify(std::span<const uint32_t>{welded}, weldedVertices.size(), cacheSize)
+            };
+
+            for (size_t list = 0; list < lists.size(); ++list)
+            {
+                for (size_t policy = 0; policy < policies.size(); ++policy)
+                {
+                    misses[list][policy] += VertexCache::GetAcmr(std::span<const uint32_t>{lists[list]}, cacheSize,
+                                                                 policies[policy]) * quadCount * 2;
+                }
+            }
+
+            triangles += static_cast<size_t>(quadCount) * 2;
+            weldedLists.emplace_back(std::move(welded), weldedVertices.size());
+        }
+
+        const double duration = Benchmark::Measure([&]
+        {
+            size_t indices = 0;
+            for (const auto& [welded, vertexCount] : weldedLists)
+            {
+                indices += VertexCache::Tipsify(std::span<const uint32_t>{welded}, vertexCount, cacheSize).size();
+            }
+            Benchmark::Sink = indices;
+        }, 5) / static_cast<double>(volumes.size());
+
+        const auto getAcmr = [&misses, triangles](const size_t list, const size_t policy)
+        {
+            return misses[list][policy] / static_cast<double>(std::max<size_t>(triangles, 1));
+        };
+
+        BOOST_LOG_TRIVIAL(info) << "Meshing vertex cache: ACMR with " << cacheSize << " FIFO / LRU entries "
+            << "against a floor of 2: " << getAcmr(0, 0) << " / " << getAcmr(0, 1) << " for the quad list, "
+            << getAcmr(1, 0) << " / " << getAcmr(1, 1) << " reordered, " << getAcmr(2, 0) << " / " << getAcmr(2, 1)
+            << " welded, " << getAcmr(3, 0) << " / " << getAcmr(3, 1) << " welded and reordered in "
+            << duration / 1000.0 << " us per section";
+    }
+
+    /**
+     * \brief Downsamples and meshes every section at every level of detail, with the neighbours at the same level.
+     * Then estimates the triangles and bytes of the meshes in view for growing view distances, with and without
+     * levels of detail.
+     * \param volumes The sections at the full resolution.
+     * \param origins The world position of the first block of every section.
+     * \param getBlockId Returns the block id at a world position, including the cells of the neighbouring sections.
+     */
+    template <class GetBlockId>
+    void RunLevelsOfDetail(const std::vector<PaddedVolume<Geometry>>& volumes,
+                           const std::vector<std::array<int, 3>>& origins, const GetBlockId& getBlockId)
+    {
+        using Detail = LevelOfDetail<Geometry>;
+
+        const BinaryMesher<Geometry> mesher;
+        ChunkMeshData meshData;
+        PaddedVolume<Geometry> downsampled;
+
+        // The triangles and bytes of every level for all sections
+        std::array<size_t, Detail::LevelCount> levelTriangles{};
+        std::array<size_t, Detail::LevelCount> levelBytes{};
+
+        for (int level = 0; level < Detail::LevelCount; ++level)
+        {
+            Detail::BorderLevels borderLevels{};
+            borderLevels.fill(level);
+
+            const auto downsample = [&](const size_t i)
+            {
+                const auto [originX, originY, originZ] = origins[i];
+                downsampled = volumes[i];
+                Detail::Downsample(downsampled, level, borderLevels, [&](const int x, const int y, const int z)
+                {
+                    return getBlockId(originX + x, originY + y, originZ + z);
+                });
+            };
+
+            size_t triangles = 0;
+            size_t bytes = 0;
+            for (size_t i = 0; i < volumes.size(); ++i)
+            {
+                downsample(i);
+                mesher.Generate(downsampled, meshData);
+                triangles += meshData.GetQuadCount() * 2;
+                bytes += GetMemoryUsage(meshData);
+            }
+
+            const double downsampleDuration = Benchmark::Measure([&]
+            {
+                for (size_t i = 0; i < volumes.size(); ++i)
+                {
+                    downsample(i);
+                }
+                Benchmark::Sink = downsampled.Get(0, 0, 0);
+            }, 5) / static_cast<double>(volumes.size());
+
+            BOOST_LOG_TRIVIAL(info) << "Meshing level of detail " << level << ": cells of "
+                << Detail::GetCellSize(level) << " blocks, " << downsampleDuration / 1000.0
+                << " us per section to downsample, " << triangles << " triangles, " << bytes << " B for "
+                << volumes.size() << " sections";
+
+            levelTriangles[level] = triangles;
+            levelBytes[level] = bytes;
+        }
+
+        // Estimates the meshes in view from the average measured column. The levels are chosen like
+        // World::GetLevelOfDetail with its default detail distance: the first level starts at 4 chunks and every
+        // further one at twice the distance.
+        constexpr int detailDistance = 4;
+        const double columns = static_cast<double>(volumes.size()) / Benchmark::ColumnGeometry::SectionsPerChunk;
+
+        for (const int radius : {8, 16, 32})
+        {
+            double triangles = 0.0;
+            double bytes = 0.0;
+            size_t viewColumns = 0;
+            for (int z = -radius; z <= radius; ++z)
+            {
+                for (int x = -radius; x <= radius; ++x)
+                {
+                    // The same circle as World::IsWithinView
+                    if (x * x + z * z > radius * (radius + 1)) continue;
+
+                    const int distance = std::max(std::abs(x), std::abs(z));
+                    int level = 0;
+                    for (int limit = detailDistance; distance >= limit && level < Detail::LevelCount - 1; limit *= 2)
+                    {
+                        ++level;
+                    }
+
+                    triangles += static_cast<double>(levelTriangles[level]) / columns;
+                    bytes += static_cast<double>(levelBytes[level]) / columns;
+                    ++viewColumns;
+                }
+            }
+
+            const double fullTriangles = static_cast<double>(levelTriangles[0]) / columns * viewColumns;
+            const double fullBytes = static_cast<double>(levelBytes[0]) / columns * viewColumns;
+
+            BOOST_LOG_TRIVIAL(info) << "Meshing level of detail view of " << radius << " chunks: " << viewColumns
+                << " columns, " << static_cast<size_t>(triangles) << " triangles and " << static_cast<size_t>(bytes)
+                << " B with levels of detail instead of " << static_cast<size_t>(fullTriangles) << " triangles and "
+                << static_cast<size_t>(fullBytes) << " B (" << fullTriangles / triangles << "x fewer)";
+        }
+    }
+}
+
+void Benchmark::RunMeshing()
+{
+    constexpr int chunkRadius = 2;
+
+    // One more ring of columns is generated so the sections at the border have their neighbours
+    std::vector<std::vector<uint8_t>> chunks;
+    for (int x = -chunkRadius - 1; x <= chunkRadius; ++x)
+    {
+        for (int z = -chunkRadius - 1; z <= chunkRadius; ++z)
+        {
+            chunks.push_back(GenerateColumn(x, z));
+        }
+    }
+
+    constexpr int chunksPerRow = 2 * chunkRadius + 2;
+    const auto getBlockId = [&chunks](const int x, const int y, const int z) -> uint8_t
+    {
+        if (y < 0 || y >= ColumnGeometry::Height) return 0;
+
+        const int chunkX = x / Geometry::Width;
+        const int chunkZ = z / Geometry::Depth;
+        const std::vector<uint8_t>& blocks = chunks[chunkX * chunksPerRow + chunkZ];
+        return blocks[ColumnGeometry::GetFlatIndex(x - chunkX * Geometry::Width, y, z - chunkZ * Geometry::Depth)];
+    };
+
+    std::vector<PaddedVolume<Geometry>> volumes;
+    std::vector<std::array<int, 3>> origins;
+    for (int chunkX = 1; chunkX < chunksPerRow - 1; ++chunkX)
+    {
+        for (int chunkZ = 1; chunkZ < chunksPerRow - 1; ++chunkZ)
+        {
+            for (int section = 0; section < ColumnGeometry::SectionsPerChunk; ++section)
+            {
+                origins.push_back({
+                    chunkX * Geometry::Width, section * Geometry::SectionHeight, chunkZ * Geometry::Depth
+                });
+                CopyVolume(origins.back(), getBlockId, volumes.emplace_back());
+            }
+        }
+    }
+
+    // The surface of the first mesher is the reference every other mesher has to match
+    std::vector<std::vector<uint64_t>> reference;
+
+    // The meshers after the greedy one are compared against it, the binary mesher has to be at least 10x as fast
+    double greedyDuration = 0.0;
+
+    for (const auto& mesher : GetMeshers<Geometry>())
+    {
+        size_t triangles = 0;
+        size_t bytes = 0;
+        size_t mismatches = 0;
+
+        for (size_t i = 0; i < volumes.size(); ++i)
+        {
+            const ChunkMeshData meshData = mesher->Generate(volumes[i]);
+            triangles += meshData.GetQuadCount() * 2;
+            bytes += GetMemoryUsage(meshData);
+
+            std::vector<uint64_t> surface = GetSurface(meshData);
+            if (reference.size() < volumes.size())
+            {
+                reference.push_back(std::move(surface));
+            }
+            else
+            {
+                mismatches += surface != reference[i];
+            }
+        }
+
+        const double duration = Measure([&]
+        {
+            uint64_t vertices = 0;
+            for (const auto& volume : volumes)
+            {
+                vertices += mesher->Generate(volume).vertices.size();
+            }
+            Sink = vertices;
+        }, 20) / static_cast<double>(volumes.size());
+
+        // Like the mesh workers, which keep their output buffers between sections
+        const double reusedDuration = Measure([&]
+        {
+            ChunkMeshData meshData;
+            uint64_t vertices = 0;
+            for (const auto& volume : volumes)
+            {
+                mesher->Generate(volume, meshData);
+                vertices += meshData.vertices.size();
+            }
+            Sink = vertices;
+        }, 20) / static_cast<double>(volumes.size());
+
+        BOOST_LOG_TRIVIAL(info) << "Meshing " << mesher->GetName() << ": " << duration / 1000.0 << " us per section ("
+            << 1e9 / duration << " sections/s), " << reusedDuration / 1000.0 << " us reusing the output, "
+            << triangles << " triangles, " << bytes << " B for " << volumes.size() << " sections, " << mismatches
+            << " sections with a different surface";
+
+        if (mesher->GetName() == "greedy")
+        {
+            greedyDuration = reusedDuration;
+        }
+        else if (greedyDuration > 0.0)
+        {
+            BOOST_LOG_TRIVIAL(info) << "Meshing " << mesher->GetName() << ": " << greedyDuration / reusedDuration
+                << "x as fast as greedy reusing the output";
+        }
+    }
+
+    RunMeshCache("generated", volumes);
+
+    // Superflat worlds are the best case for the cache: every section of a layer has the same blocks and borders.
+    // The same number of columns as above is meshed, only the sections that contain blocks.
+    constexpr int superflatHeight = 28;
+    const auto getSuperflatBlockId = [](int, const int y, int) -> uint8_t
+    {
+        if (y < 0 || y >= superflatHeight) return Block::Air.GetId();
+        if (y == superflatHeight - 1) return Block::Grass.GetId();
+        return y >= superflatHeight - 4 ? Block::Dirt.GetId() : Block::Stone.GetId();
+    };
+
+    std::vector<PaddedVolume<Geometry>> superflatVolumes;
+    for (int chunkX = 0; chunkX < 2 * chunkRadius; ++chunkX)
+    {
+        for (int chunkZ = 0; chunkZ < 2 * chunkRadius; ++chunkZ)
+        {
+            for (int section = 0; section * Geometry::SectionHeight < superflatHeight; ++section)
+            {
+                CopyVolume({chunkX * Geometry::Width, section * Geometry::SectionHeight, chunkZ * Geometry::Depth},
+                           getSuperflatBlockId, superflatVolumes.emplace_back());
+            }
+        }
+    }
+    RunMeshCache("superflat", superflatVolumes);
+
+    RunColliders(volumes);
+    RunVertexCache(volumes);
+    RunLevelsOfDetail(volumes, origins, getBlockId);
+    RunPatching(std::move(volumes));
+}
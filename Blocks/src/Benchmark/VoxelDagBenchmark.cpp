@@ -0,0 +1,92 @@
+﻿#include "Blocks/pch.h"
+#include "Blocks/Benchmark/Benchmark.h"
+
+#include <boost/log/trivial.hpp>
+
+#include "Blocks/World/Chunk.h"
+#include "Blocks/World/VoxelDag.h"
+#include "Blocks/World/World.h"
+
+using namespace Blocks;
+
+void Benchmark::RunVoxelDag()
+{
+    constexpr int chunkRadius = 8;
+
+    std::vector<std::vector<uint8_t>> sections;
+    size_t flatMemory = 0;
+    size_t paletteMemory = 0;
+
+    for (int x = -chunkRadius; x < chunkRadius; ++x)
+    {
+        for (int z = -chunkRadius; z < chunkRadius; ++z)
+        {
+            for (int y = 0; y < ColumnGeometry::Height / Chunk::Height; ++y)
+            {
+                const Chunk::ChunkData blocks = World::GenerateChunk({x, y, z});
+                flatMemory += blocks.size();
+
+                for (const auto& section : Chunk::SplitIntoSections(blocks))
+                {
+                    paletteMemory += sizeof(section);
+                    if (!section) continue;
+
+                    paletteMemory += section->GetMemoryUsage();
+                    sections.emplace_back(Chunk::SectionSize);
+                    section->CopyTo(sections.back());
+                }
+            }
+        }
+    }
+
+    VoxelDag dag;
+    std::vector<VoxelDag::NodeRef> roots;
+    roots.reserve(sections.size());
+    for (const auto& section : sections)
+    {
+        roots.push_back(dag.Insert(section));
+    }
+    const size_t dagMemory = dag.GetMemoryUsage() + roots.size() * sizeof(VoxelDag::NodeRef);
+
+    // Archiving and restoring a section in a DAG that already contains the rest of the world
+    size_t next = 0;
+    const double insert = Measure([&]
+    {
+        const VoxelDag::NodeRef root = dag.Insert(sections[next]);
+        dag.Release(root);
+        next = (next + 1) % sections.size();
+        Sink = root;
+    }, static_cast<int>(sections.size()));
+
+    std::vector<uint8_t> expanded(Chunk::SectionSize);
+    next = 0;
+    const double expand = Measure([&]
+    {
+        dag.Expand(roots[next], expanded);
+        next = (next + 1) % roots.size();
+        Sink = expanded[next % expanded.size()];
+    }, static_cast<int>(roots.size()));
+
+    // A neighbour of an archived section that is meshed only reads the face that touches it from the DAG
+    next = 0;
+    const double expandFace = Measure([&]
+    {
+        dag.ExpandRegion(roots[next], {0, 0, 0}, {0, Chunk::SectionHeight - 1, Chunk::Depth - 1}, expanded);
+        next = (next + 1) % roots.size();
+        Sink = expanded[next % expanded.size()];
+    }, static_cast<int>(roots.size()));
+
+    BOOST_LOG_TRIVIAL(info) << "VoxelDag: " << sections.size() << " non empty sections, " << dag.GetNodeCount()
+        << " shared nodes";
+    BOOST_LOG_TRIVIAL(info) << "VoxelDag: memory flat " << flatMemory << " B, palette " << paletteMemory
+        << " B, dag " << dagMemory << " B (" << static_cast<double>(flatMemory) / static_cast<double>(dagMemory)
+        << "x smaller than flat, " << static_cast<double>(paletteMemory) / static_cast<double>(dagMemory)
+        << "x smaller than palette)";
+    BOOST_LOG_TRIVIAL(info) << "VoxelDag: archive " << insert / 1000.0 << " us, expand " << expand / 1000.0
+        << " us per section, expand a face " << expandFace / 1000.0 << " us";
+
+    for (const VoxelDag::NodeRef root : roots)
+    {
+        dag.Release(root);
+    }
+}
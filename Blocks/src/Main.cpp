@@ -1,14 +1,17 @@
 ﻿#include "Blocks/pch.h"
 
 #include <chrono>
+#include <string_view>
 #include <thread>
 #include <Blocks/Player/PlayerMovement.h>
 #include <boost/log/trivial.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
 #include <boost/log/utility/setup/file.hpp>
 
+#include "Blocks/Benchmark/Benchmark.h"
 #include "Blocks/Player/PlayerDebugs.h"
 #include "Blocks/World/World.h"
+#include "Blocks/World/Meshing/Meshers.h"
 #include "BlocksEngine/Core/Actor.h"
 #include "BlocksEngine/Core/Components/CharacterController.h"
 #include "BlocksEngine/Exceptions/Exception.h"
@@ -32,6 +35,28 @@ void SetupLogging()
     Logging::add_common_attributes();
 }
 
+/**
+ * \brief Reads the mesher selected with --mesher=<name> from the command line.
+ * \return The selected mesher, nullptr to use the default mesher.
+ */
+std::shared_ptr<const Blocks::Chunk::SectionMesher> GetMesher(const std::string_view commandLine)
+{
+    constexpr std::string_view option{"--mesher="};
+
+    const size_t start = commandLine.find(option);
+    if (start == std::string_view::npos) return nullptr;
+
+    const std::string_view name = commandLine.substr(start + option.size(),
+                                                     commandLine.find(' ', start) - start - option.size());
+
+    auto mesher = Blocks::FindMesher<Blocks::Chunk::Geometry>(name);
+    if (!mesher)
+    {
+        BOOST_LOG_TRIVIAL(warning) << "Unknown mesher " << name << ", using the default mesher";
+    }
+
+    return mesher;
+}
 
 int WINAPI WinMain(
     _In_ HINSTANCE hInstance,
@@ -41,16 +66,20 @@ int WINAPI WinMain(
 {
     UNREFERENCED_PARAMETER(hInstance);
     UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
     UNREFERENCED_PARAMETER(nShowCmd);
 
     SetupLogging();
 
+    if (std::string_view{lpCmdLine}.find("--benchmark") != std::string_view::npos)
+    {
+        return Blocks::Benchmark::RunAll();
+    }
+
     try
     {
         auto game = BlocksEngine::Game::CreateGame();
 
-        game->AddSignalGameStart([&game]
+        game->AddSignalGameStart([&game, mesher = GetMesher(lpCmdLine)]
         {
             const auto playerActor = game->AddActor(L"Player");
 
@@ -69,7 +98,7 @@ int WINAPI WinMain(
             playerActor->AddComponent<Blocks::PlayerDebugs>();
 
             const auto worldActor = game->AddActor(L"World");
-            worldActor->AddComponent<Blocks::World>(game->MainCamera().GetTransform(), 10);
+            worldActor->AddComponent<Blocks::World>(game->MainCamera().GetTransform(), 5, 4, mesher);
         });
         return game->Start();
     }
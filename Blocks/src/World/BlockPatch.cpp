@@ -0,0 +1,42 @@
+﻿#include "Blocks/pch.h"
+#include "Blocks/World/BlockPatch.h"
+
+#include <cassert>
+
+using namespace Blocks;
+using namespace BlocksEngine;
+
+BlockPatch::BlockPatch(const Vector3<int> size, const uint8_t blockId)
+    : size_{size},
+      blocks_(static_cast<size_t>(size.x) * size.y * size.z, blockId)
+{
+}
+
+uint8_t BlockPatch::Get(const Vector3<int> position) const noexcept
+{
+    return blocks_[GetIndex(position)];
+}
+
+void BlockPatch::Set(const Vector3<int> position, const uint8_t blockId) noexcept
+{
+    blocks_[GetIndex(position)] = blockId;
+}
+
+Vector3<int> BlockPatch::GetSize() const noexcept
+{
+    return size_;
+}
+
+std::span<const uint8_t> BlockPatch::GetRow(const Vector3<int> position, const int length) const noexcept
+{
+    assert(position.x + length <= size_.x);
+    return std::span{blocks_}.subspan(GetIndex(position), length);
+}
+
+size_t BlockPatch::GetIndex(const Vector3<int> position) const noexcept
+{
+    assert(position.x >= 0 && position.x < size_.x);
+    assert(position.y >= 0 && position.y < size_.y);
+    assert(position.z >= 0 && position.z < size_.z);
+    return position.x + (static_cast<size_t>(position.y) * size_.z + position.z) * size_.x;
+}
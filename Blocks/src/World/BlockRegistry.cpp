@@ -18,6 +18,16 @@ const robin_hood::unordered_map<uint8_t, const Blocks::Block&>& Blocks::BlockReg
     return Instance().blocks_;
 }
 
+const Blocks::BlockRegistry::SeeThroughTable& Blocks::BlockRegistry::GetSeeThroughTable()
+{
+    return Instance().seeThrough_;
+}
+
+const Blocks::BlockRegistry::TextureTable& Blocks::BlockRegistry::GetTextureTable()
+{
+    return Instance().textures_;
+}
+
 Blocks::BlockRegistry& Blocks::BlockRegistry::Instance()
 {
     static BlockRegistry instance;
@@ -34,4 +44,9 @@ Blocks::BlockRegistry::BlockRegistry():
         }
     }
 {
+    for (const auto& [id, block] : blocks_)
+    {
+        seeThrough_[id] = block.IsSeeThrough();
+        textures_[id] = block.GetTextures();
+    }
 }
@@ -0,0 +1,164 @@
+﻿#include "Blocks/pch.h"
+#include "Blocks/World/BlockStorage.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+using namespace Blocks;
+
+BlockStorage::BlockStorage(const size_t size, const uint8_t blockId)
+    : size_{size},
+      palette_{blockId}
+{
+}
+
+BlockStorage::BlockStorage(const std::span<const uint8_t> blocks)
+    : size_{blocks.size()}
+{
+    // Maps a block id to its index in the palette, -1 if it is not part of the palette yet.
+    std::array<int16_t, 256> lookup{};
+    lookup.fill(-1);
+
+    for (const uint8_t blockId : blocks)
+    {
+        if (lookup[blockId] < 0)
+        {
+            lookup[blockId] = static_cast<int16_t>(palette_.size());
+            palette_.push_back(blockId);
+        }
+    }
+
+    if (palette_.empty())
+    {
+        palette_.push_back(0);
+    }
+
+    bitsPerBlock_ = BitsForPaletteSize(palette_.size());
+    if (bitsPerBlock_ == 0) return;
+
+    data_.resize((size_ * bitsPerBlock_ + 63) / 64);
+    for (size_t i = 0; i < size_; ++i)
+    {
+        SetPaletteIndex(i, static_cast<uint8_t>(lookup[blocks[i]]));
+    }
+}
+
+void BlockStorage::Set(const size_t index, const uint8_t blockId)
+{
+    assert(index < size_);
+
+    size_t paletteIndex = 0;
+    while (paletteIndex < palette_.size() && palette_[paletteIndex] != blockId)
+    {
+        ++paletteIndex;
+    }
+
+    if (paletteIndex == palette_.size())
+    {
+        palette_.push_back(blockId);
+
+        if (const uint8_t bitsPerBlock = BitsForPaletteSize(palette_.size()); bitsPerBlock != bitsPerBlock_)
+        {
+            Repack(bitsPerBlock);
+        }
+    }
+
+    if (bitsPerBlock_ == 0) return;
+
+    SetPaletteIndex(index, static_cast<uint8_t>(paletteIndex));
+}
+
+void BlockStorage::Fill(const uint8_t blockId)
+{
+    bitsPerBlock_ = 0;
+    palette_.assign(1, blockId);
+    data_.clear();
+    data_.shrink_to_fit();
+}
+
+void BlockStorage::CopyTo(const std::span<uint8_t> destination) const noexcept
+{
+    assert(destination.size() >= size_);
+
+    if (bitsPerBlock_ == 0)
+    {
+        std::fill_n(destination.begin(), size_, palette_[0]);
+        return;
+    }
+
+    const size_t blocksPerWord = 64 / bitsPerBlock_;
+    const uint64_t mask = (uint64_t{1} << bitsPerBlock_) - 1;
+
+    size_t i = 0;
+    for (const uint64_t word : data_)
+    {
+        uint64_t bits = word;
+        for (size_t j = 0; j < blocksPerWord && i < size_; ++j, ++i)
+        {
+            destination[i] = palette_[bits & mask];
+            bits >>= bitsPerBlock_;
+        }
+    }
+}
+
+size_t BlockStorage::Size() const noexcept
+{
+    return size_;
+}
+
+bool BlockStorage::IsUniform() const noexcept
+{
+    return bitsPerBlock_ == 0;
+}
+
+uint8_t BlockStorage::GetBitsPerBlock() const noexcept
+{
+    return bitsPerBlock_;
+}
+
+const std::vector<uint8_t>& BlockStorage::GetPalette() const noexcept
+{
+    return palette_;
+}
+
+size_t BlockStorage::GetMemoryUsage() const noexcept
+{
+    return sizeof(BlockStorage) + palette_.capacity() + data_.capacity() * sizeof(uint64_t);
+}
+
+uint8_t BlockStorage::BitsForPaletteSize(const size_t paletteSize) noexcept
+{
+    if (paletteSize <= 1) return 0;
+    if (paletteSize <= 2) return 1;
+    if (paletteSize <= 4) return 2;
+    if (paletteSize <= 16) return 4;
+    return 8;
+}
+
+void BlockStorage::SetPaletteIndex(const size_t index, const uint8_t paletteIndex) noexcept
+{
+    const size_t bit = index * bitsPerBlock_;
+    const uint64_t mask = (uint64_t{1} << bitsPerBlock_) - 1;
+
+    uint64_t& word = data_[bit >> 6];
+    word &= ~(mask << (bit & 63));
+    word |= static_cast<uint64_t>(paletteIndex) << (bit & 63);
+}
+
+void BlockStorage::Repack(const uint8_t bitsPerBlock)
+{
+    std::vector<uint8_t> indices(size_);
+    for (size_t i = 0; i < size_; ++i)
+    {
+        indices[i] = GetPaletteIndex(i);
+    }
+
+    bitsPerBlock_ = bitsPerBlock;
+    data_.assign((size_ * bitsPerBlock_ + 63) / 64, 0);
+
+    for (size_t i = 0; i < size_; ++i)
+    {
+        SetPaletteIndex(i, indices[i]);
+    }
+}
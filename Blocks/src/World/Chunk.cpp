@@ -1,16 +1,19 @@
 ﻿#include "Blocks/pch.h"
 #include "Blocks/World/Chunk.h"
 
+#include <cstdlib>
+#include <limits>
 #include <BlocksEngine/Exceptions/EngineException.h>
 
 #include "Blocks/World/BlockRegistry.h"
+#include "Blocks/World/BoxDecomposition.h"
 #include "Blocks/World/World.h"
 #include "BlocksEngine/Core/Actor.h"
 #include "BlocksEngine/Core/Components/Collider.h"
 #include "BlocksEngine/Core/Components/Renderer.h"
 #include "BlocksEngine/Core/Dispatch/DispatchQueue.h"
 #include "BlocksEngine/Core/Math/Vector3.h"
-#include "BlocksEngine/Core/Math/Vertex.h"
+#include "BlocksEngine/Core/Math/TerrainVertex.h"
 #include "BlocksEngine/Graphics/Material/Terrain/Terrain.h"
 #include "BlocksEngine/Main/Game.h"
 
@@ -23,8 +26,10 @@ using namespace BlocksEngine;
 
 Chunk::ChunkSection::ChunkSection(const Chunk& chunk, const int section)
     : chunk_{chunk},
-      section_{section}
+      section_{section},
+      snapshot_{std::make_shared<const Snapshot>(Snapshot{0, nullptr})}
 {
+    UpdateMemoryUsage();
 }
 
 void Chunk::ChunkSection::Start()
@@ -33,301 +38,561 @@ void Chunk::ChunkSection::Start()
     {
         terrainTexture_ = Texture2D::FromDds(GetGame()->Graphics(), L"resources/images/terrain.dds");
     }
+}
 
-    renderer_ = std::move(GetActor()->AddComponent<Renderer>());
-
-    auto material = std::make_shared<Terrain>(GetActor()->GetGame()->Graphics(), terrainTexture_);
-    renderer_->SetMaterial(std::move(material));
+template <class GetBlock>
+std::vector<Collider::Box> Chunk::ChunkSection::GetColliderBoxes(const GetBlock& getBlock)
+{
+    std::vector<Collider::Box> boxes;
+    BoxDecomposition<Geometry>::Decompose(getBlock, [&boxes](const std::array<int, 3> min,
+                                                             const std::array<int, 3> max)
+    {
+        boxes.push_back({
+            {static_cast<float>(min[0]), static_cast<float>(min[1]), static_cast<float>(min[2])},
+            {static_cast<float>(max[0]), static_cast<float>(max[1]), static_cast<float>(max[2])}
+        });
+    });
+    return boxes;
 }
 
 std::unique_ptr<DispatchWorkItem> Chunk::ChunkSection::RegenerateMesh()
 {
-    // Based on the post of: https://0fps.net/2012/06/30/meshing-in-a-minecraft-game/
-    // and https://github.com/Vercidium/voxel-mesh-generation
-
-    // TODO: Implement https://vercidium.com/blog/voxel-world-optimisations/
-    return std::make_unique<DispatchWorkItem>([this]
+    // Only the snapshots are taken on the calling thread, the worker never reads from other sections or chunks
+    SectionNeighbourhood neighbourhood = chunk_.GetSectionNeighbourhood(section_);
+    const uint64_t version = neighbourhood[GetNeighbourhoodIndex(0, 0, 0)]->version;
+    const uint64_t meshRequest = ++meshRequest_;
+    ++pendingJobs_;
+
+    return std::make_unique<DispatchWorkItem>([this, neighbourhood = std::move(neighbourhood), version, meshRequest,
+            mesher = chunk_.GetWorld().GetMesher(), level = chunk_.GetLevelOfDetail(),
+            borderLevels = chunk_.GetBorderLevels()]
     {
-        std::vector<Vertex> vertices;
-        std::vector<physx::PxVec3> colliderVertices;
-        std::vector<int32_t> indices;
+        // The volume and the render vertices are reused by every section this worker meshes
+        MeshScratch<Geometry>& scratch = MeshScratch<Geometry>::ForCurrentThread();
+        CopySectionVolume(neighbourhood, scratch.volume);
+
+        // The collider keeps the full resolution at every level of detail
+        std::vector<Collider::Box> colliderBoxes = GetColliderBoxes(
+            [&volume = scratch.volume](const int x, const int y, const int z)
+            {
+                return volume.Get(x, y, z);
+            });
+
+        SectionLevelOfDetail::Downsample(scratch.volume, level, borderLevels,
+                                         [&neighbourhood](const int x, const int y, const int z)
+                                         {
+                                             return GetNeighbourhoodBlock(neighbourhood, x, y, z);
+                                         });
 
-        constexpr int dimensions[3] = {Width, SectionHeight, Depth};
+        // Sections with the same blocks and borders, like the layers of flat terrain, share a single mesh
+        MeshCache<Geometry>& cache = MeshCache<Geometry>::Instance();
+        const uint64_t hash = scratch.volume.GetHash();
+        std::shared_ptr<const MeshCache<Geometry>::Entry> entry = cache.Find(scratch.volume, hash);
 
-        for (int i = 0; i < dimensions[0]; ++i)
+        if (!entry)
         {
-            for (int j = 0; j < dimensions[1]; ++j)
+            ChunkMeshData& meshData = scratch.meshData;
+            mesher->Generate(scratch.volume, meshData);
+
+            // A section can be completely enclosed by other blocks
+            if (meshData.vertices.empty())
             {
-                for (int k = 0; k < dimensions[2]; ++k)
+                GetGame()->MainDispatchQueue()->Async(std::make_shared<DispatchWorkItem>([this, version, meshRequest]
                 {
-                    if (GetBlock({i, j, k}) != Block::Air)
-                    {
-                        goto mesh;
-                    }
-                }
+                    --pendingJobs_;
+                    if (IsMeshStale(version, meshRequest)) return;
+                    ClearMesh();
+                }));
+                return;
             }
-        }
-        GetGame()->MainDispatchQueue()->Async(std::make_shared<DispatchWorkItem>([this]
-        {
-            renderer_->SetMesh(nullptr);
-        }));
-        return;
 
-    mesh:
+            const Graphics& gfx = GetGame()->Graphics();
 
-        // Loop over every axis (x, y, z)
-        for (int dim = 0; dim < 3; ++dim)
-        {
-            int k;
-            const int u = (dim + 1) % 3;
-            const int v = (dim + 2) % 3;
+            // Every face direction of the opaque and of the see-through blocks gets its own range with spare room for
+            // the quads added by patches, which are never drawn until then. Only the vertices are uploaded, all
+            // sections share the same quad index buffer.
+            SectionQuads<Geometry> quads;
+            quads.Reset(scratch.quads);
+            quads.SpreadVertices(meshData.vertices);
+
+            auto vertexBuffer = std::make_shared<VertexBuffer>(gfx, meshData.vertices);
+            const std::shared_ptr<IndexBuffer> indexBuffer = IndexBuffer::GetQuadList(gfx, quads.GetSlotCount());
 
-            int x[3] = {0, 0, 0};
-            int q[3] = {0, 0, 0};
-            q[dim] = 1;
+            auto mesh = std::make_shared<Mesh>(vertexBuffer, indexBuffer);
+            mesh->SetSubMeshes(GetSubMeshes(quads, false));
 
-            std::vector<int> mask(dimensions[u] * dimensions[v]);
+            auto translucentMesh = std::make_shared<Mesh>(vertexBuffer, indexBuffer);
+            translucentMesh->SetSubMeshes(GetSubMeshes(quads, true));
 
-            // Check every slice of the chunk
-            for (x[dim] = -1; x[dim] < dimensions[dim];)
+            // Another worker might have cached the same blocks in the meantime, its mesh is used instead
+            entry = cache.Insert(std::make_shared<const MeshCache<Geometry>::Entry>(MeshCache<Geometry>::Entry{
+                scratch.volume, hash, std::move(vertexBuffer), std::move(mesh), std::move(translucentMesh),
+                std::move(quads)
+            }));
+        }
+
+        GetGame()->MainDispatchQueue()->Async(std::make_shared<DispatchWorkItem>(
+            [this, entry = std::move(entry), version, meshRequest, colliderBoxes = std::move(colliderBoxes)]() mutable
             {
-                // Compute the mask
-                int n = 0;
-                for (x[v] = 0; x[v] < dimensions[v]; ++x[v])
-                {
-                    for (x[u] = 0; x[u] < dimensions[u]; ++x[u], ++n)
-                    {
-                        const int a = GetBlock({x[0], x[1], x[2]}).GetId();
-                        const int b = GetBlock({x[0] + q[0], x[1] + q[1], x[2] + q[2]}).GetId();
-
-
-                        if (static_cast<bool>(a) == static_cast<bool>(b))
-                        {
-                            mask[n] = 0;
-                        }
-                        else if (static_cast<bool>(a))
-                        {
-                            mask[n] = a;
-                        }
-                        else
-                        {
-                            mask[n] = -b;
-                        }
-                    }
-                }
+                --pendingJobs_;
+
+                // The blocks might have changed or a newer mesh was requested while this one was being generated
+                if (IsMeshStale(version, meshRequest)) return;
+
+                mesh_ = entry->mesh;
+                translucentMesh_ = entry->translucentMesh;
+                vertexBuffer_ = entry->vertexBuffer;
+                quads_ = entry->quads;
+                cacheEntry_ = std::move(entry);
+                ShowMeshes();
 
-                ++x[dim];
+                meshVersion_ = version;
+                appliedMeshRequest_ = meshRequest;
 
-                // Generate mesh for the current mask
-                n = 0;
+                // Colliders of earlier patches that are still being built are outdated
+                ++colliderRequest_;
 
-                for (int j = 0; j < dimensions[v]; ++j)
+                // The collider is reused so only its shapes are replaced
+                if (collider_)
                 {
-                    for (int i = 0; i < dimensions[u];)
-                    {
-                        if (int blockId = mask[n]; static_cast<bool>(blockId))
-                        {
-                            // Compute width of the face
-                            int width = 1;
-                            while (i + width < dimensions[u] && blockId == mask[static_cast<unsigned long long>(n) +
-                                width])
-                            {
-                                ++width;
-                            }
-
-                            // Compute height of the face
-                            int height = 1;
-                            while (j + height < dimensions[v])
-                            {
-                                for (k = 0; k < width; ++k)
-                                {
-                                    if (blockId != mask[
-                                        static_cast<unsigned long long>(n)
-                                        + k
-                                        + static_cast<unsigned long long>(height)
-                                        * dimensions[u]])
-                                    {
-                                        goto afterLoop;
-                                    }
-                                }
-                                ++height;
-                            }
-                        afterLoop:
-
-                            x[u] = i;
-                            x[v] = j;
-
-                            // Determine the size and orientation of this face
-                            int du[3] = {0, 0, 0};
-                            int dv[3] = {0, 0, 0};
-
-                            const bool flipUvs = q[0] == 1 && blockId > 0
-                                || q[1] == 1 && blockId < 0
-                                || q[2] == 1 && blockId < 0;
-
-                            const uint8_t faceId = q[0] * (blockId < 0 ? 3 : 1)
-                                + q[1] * (blockId < 0 ? 5 : 4)
-                                + q[2] * (blockId < 0 ? 2 : 0);
-
-
-                            // If blockId is less than 0 the face is flipped
-                            if (blockId > 0)
-                            {
-                                dv[v] = height;
-                                du[u] = width;
-                            }
-                            else
-                            {
-                                blockId = -blockId;
-                                du[v] = height;
-                                dv[u] = width;
-                            }
-
-                            int uv[2] = {0, 0};
-
-                            if (q[0] == 1)
-                            {
-                                uv[0] = width;
-                                uv[1] = height;
-                            }
-                            else
-                            {
-                                uv[0] = height;
-                                uv[1] = width;
-                            }
-
-                            const Block& block = BlockRegistry::GetBlock(blockId);
-
-                            colliderVertices.push_back({
-                                static_cast<float>(x[0]),
-                                static_cast<float>(x[1]),
-                                static_cast<float>(x[2])
-                            });
-
-                            colliderVertices.push_back({
-                                static_cast<float>(x[0] + du[0]),
-                                static_cast<float>(x[1] + du[1]),
-                                static_cast<float>(x[2] + du[2])
-                            });
-
-                            colliderVertices.push_back({
-                                static_cast<float>(x[0] + dv[0]),
-                                static_cast<float>(x[1] + dv[1]),
-                                static_cast<float>(x[2] + dv[2])
-                            });
-
-                            colliderVertices.push_back({
-                                static_cast<float>(x[0] + du[0] + dv[0]),
-                                static_cast<float>(x[1] + du[1] + dv[1]),
-                                static_cast<float>(x[2] + du[2] + dv[2])
-                            });
-
-                            int vertexCount = static_cast<int>(vertices.size());
-                            vertices.push_back(Vertex{
-                                {
-                                    static_cast<float>(x[0]),
-                                    static_cast<float>(x[1]),
-                                    static_cast<float>(x[2])
-                                },
-                                {static_cast<float>(flipUvs ? 0 : uv[1]), static_cast<float>(uv[0])},
-                                block.GetTextures()[faceId]
-                            });
-
-                            vertices.push_back(Vertex{
-                                {
-                                    static_cast<float>(x[0] + du[0]),
-                                    static_cast<float>(x[1] + du[1]),
-                                    static_cast<float>(x[2] + du[2])
-                                },
-                                {static_cast<float>(0), static_cast<float>(flipUvs ? 0 : uv[0])},
-                                block.GetTextures()[faceId]
-                            });
-
-                            vertices.push_back(Vertex{
-                                {
-                                    static_cast<float>(x[0] + dv[0]),
-                                    static_cast<float>(x[1] + dv[1]),
-                                    static_cast<float>(x[2] + dv[2])
-                                },
-                                {static_cast<float>(uv[1]), static_cast<float>(flipUvs ? uv[0] : 0)},
-                                block.GetTextures()[faceId]
-                            });
-
-                            vertices.push_back(Vertex{
-                                {
-                                    static_cast<float>(x[0] + du[0] + dv[0]),
-                                    static_cast<float>(x[1] + du[1] + dv[1]),
-                                    static_cast<float>(x[2] + du[2] + dv[2])
-                                },
-                                {static_cast<float>(flipUvs ? uv[1] : 0), static_cast<float>(0)},
-                                block.GetTextures()[faceId]
-                            });
-
-                            indices.push_back(vertexCount);
-                            indices.push_back(vertexCount + 1);
-                            indices.push_back(vertexCount + 2);
-
-                            indices.push_back(vertexCount + 1);
-                            indices.push_back(vertexCount + 3);
-                            indices.push_back(vertexCount + 2);
-
-
-                            for (int l = 0; l < height; ++l)
-                            {
-                                for (k = 0; k < width; ++k)
-                                {
-                                    mask[static_cast<unsigned long long>(n) + k + static_cast<unsigned long long>(l)
-                                        *
-                                        dimensions[u]] = 0;
-                                }
-                            }
-
-                            i += width;
-                            n += width;
-                        }
-                        else
-                        {
-                            i++;
-                            n++;
-                        }
-                    }
+                    collider_->SetBoxes(std::move(colliderBoxes));
                 }
+                else
+                {
+                    collider_ = GetActor()->AddComponent<Collider>(std::move(colliderBoxes));
+                }
+                UpdateMemoryUsage();
+            }));
+    });
+}
+
+void Chunk::ChunkSection::ClearMesh()
+{
+    cacheEntry_ = nullptr;
+    mesh_ = nullptr;
+    translucentMesh_ = nullptr;
+    vertexBuffer_ = nullptr;
+    quads_.Reset({});
+    ++colliderRequest_;
+
+    if (renderer_)
+    {
+        renderer_->SetMesh(nullptr);
+    }
+
+    if (translucentRenderer_)
+    {
+        translucentRenderer_->SetMesh(nullptr);
+    }
+
+    if (collider_)
+    {
+        collider_->SetBoxes({});
+    }
+    UpdateMemoryUsage();
+}
+
+bool Chunk::ChunkSection::PatchMesh(const Vector3<int> position)
+{
+    // The quads have to show the blocks right before this change and must not be replaced by a pending mesh job
+    if (!mesh_ || appliedMeshRequest_ != meshRequest_ || meshVersion_ + 1 < GetVersion()) return false;
+
+    // The buffers of a cached mesh can only be modified once no other section shows them
+    if (cacheEntry_)
+    {
+        if (!MeshCache<Geometry>::Instance().Detach(cacheEntry_)) return false;
+        cacheEntry_ = nullptr;
+    }
+
+    const SectionNeighbourhood neighbourhood = chunk_.GetSectionNeighbourhood(section_);
+    const bool patched = quads_.PatchBlock({position.x, position.y, position.z},
+                                           [&neighbourhood](const int x, const int y, const int z)
+                                           {
+                                               return GetNeighbourhoodBlock(neighbourhood, x, y, z);
+                                           });
+
+    if (!patched)
+    {
+        // The fragmented quads can no longer be patched, the section keeps showing its mesh until it is remeshed
+        mesh_ = nullptr;
+        translucentMesh_ = nullptr;
+        vertexBuffer_ = nullptr;
+        UpdateMemoryUsage();
+        return false;
+    }
+
+    const Graphics& gfx = GetGame()->Graphics();
+
+    ChunkMeshData quadData;
+    for (const uint32_t slot : quads_.GetChangedSlots())
+    {
+        quadData.Clear();
+        quadData.AddQuad(quads_.GetQuad(slot));
+        vertexBuffer_->Update(gfx, slot * 4, std::span<const TerrainVertex>{quadData.vertices});
+    }
+
+    mesh_->SetSubMeshes(GetSubMeshes(quads_, false));
+    translucentMesh_->SetSubMeshes(GetSubMeshes(quads_, true));
+    meshVersion_ = GetVersion();
+
+    // The first see-through block of a section needs the translucent renderer
+    ShowMeshes();
+
+    // A block in the border only changes the faces of this section, not the blocks its collider covers
+    if (position.x >= 0 && position.x < Width && position.y >= 0 && position.y < SectionHeight && position.z >= 0
+        && position.z < Depth)
+    {
+        RebuildCollider();
+    }
+    return true;
+}
+
+void Chunk::ChunkSection::RebuildCollider()
+{
+    const uint64_t colliderRequest = ++colliderRequest_;
+    ++pendingJobs_;
+
+    DispatchQueue::Background()->Async(std::make_shared<DispatchWorkItem>(
+        [this, snapshot = GetSnapshot(), colliderRequest]
+        {
+            std::array<uint8_t, SectionSize> blocks; // NOLINT(cppcoreguidelines-pro-type-member-init)
+            if (snapshot->blocks)
+            {
+                snapshot->blocks->CopyTo(blocks);
+            }
+            else
+            {
+                blocks.fill(Block::Air.GetId());
             }
+
+            std::vector<Collider::Box> colliderBoxes = GetColliderBoxes(
+                [&blocks](const int x, const int y, const int z)
+                {
+                    return blocks[Geometry::GetSectionFlatIndex(x, y, z)];
+                });
+
+            GetGame()->MainDispatchQueue()->Async(std::make_shared<DispatchWorkItem>(
+                [this, colliderRequest, colliderBoxes = std::move(colliderBoxes)]() mutable
+                {
+                    --pendingJobs_;
+                    if (colliderRequest != colliderRequest_ || !collider_) return;
+                    collider_->SetBoxes(std::move(colliderBoxes));
+                    UpdateMemoryUsage();
+                }));
+        }));
+}
+
+void Chunk::ChunkSection::ShowMeshes()
+{
+    if (!renderer_)
+    {
+        renderer_ = AddRenderer(false);
+    }
+
+    renderer_->SetMesh(mesh_);
+
+    // Most sections contain no see-through blocks and never need a second renderer
+    if (!translucentRenderer_)
+    {
+        bool hasTranslucentQuads = false;
+        for (int group = ChunkMeshData::FaceCount; group < ChunkMeshData::GroupCount; ++group)
+        {
+            hasTranslucentQuads |= !quads_.GetQuads(group).empty();
         }
 
-        const Graphics& gfx = GetGame()->Graphics();
+        if (!hasTranslucentQuads) return;
+        translucentRenderer_ = AddRenderer(true);
+    }
 
-        auto mesh = std::make_shared<Mesh>(
-            std::make_shared<VertexBuffer>(gfx, vertices),
-            std::make_shared<IndexBuffer>(gfx, indices));
+    translucentRenderer_->SetMesh(translucentMesh_);
+}
 
+std::shared_ptr<Renderer> Chunk::ChunkSection::AddRenderer(const bool translucent)
+{
+    auto renderer = GetActor()->AddComponent<Renderer>();
+    renderer->SetMaterial(std::make_shared<Terrain>(GetGame()->Graphics(), terrainTexture_));
+    if (translucent)
+    {
+        renderer->SetTranslucent(true);
 
-        GetGame()->MainDispatchQueue()->Async(std::make_shared<DispatchWorkItem>(
-            [this, mesh, colliderVertices = move(colliderVertices), indices = move(indices)]()
-        mutable
-            {
-                renderer_->SetMesh(mesh);
+        // Sections are sorted by their centre, their corner is closer to the camera for half of the directions
+        GetActor()->SetSortCenter({Width / 2.0f, SectionHeight / 2.0f, Depth / 2.0f});
+    }
+    renderer->SetEnabled(IsEnabled());
+    return renderer;
+}
 
-                GetActor()->AddComponent<Collider>(std::move(colliderVertices), std::move(indices));
-            }));
-    });
+std::vector<SubMesh> Chunk::ChunkSection::GetSubMeshes(const SectionQuads<Geometry>& quads, const bool translucent)
+{
+    std::vector<SubMesh> subMeshes;
+    subMeshes.reserve(ChunkMeshData::FaceCount);
+
+    for (int face = 0; face < ChunkMeshData::FaceCount; ++face)
+    {
+        const int group = translucent ? face + ChunkMeshData::FaceCount : face;
+        const auto [axis, sign] = ChunkMeshData::FaceDirections[face];
+        const std::vector<MeshQuad>& faceQuads = quads.GetQuads(group);
+
+        Vector3<float> normal = Vector3<float>::Zero;
+        (axis == 0 ? normal.x : axis == 1 ? normal.y : normal.z) = static_cast<float>(sign);
+
+        // The camera sees a quad of the range as soon as it lies in front of the rearmost one
+        int minDistance = std::numeric_limits<int>::max();
+        for (const MeshQuad& quad : faceQuads)
+        {
+            minDistance = std::min(minDistance, sign * quad.position[axis]);
+        }
+
+        subMeshes.push_back({
+            quads.GetOffset(group) * 6, static_cast<UINT>(faceQuads.size() * 6), normal,
+            static_cast<float>(minDistance)
+        });
+    }
+
+    return subMeshes;
 }
 
 void Chunk::ChunkSection::Enable() noexcept
 {
     SetEnabled(true);
-    renderer_->SetEnabled(true);
+    if (renderer_)
+    {
+        renderer_->SetEnabled(true);
+    }
+
+    if (translucentRenderer_)
+    {
+        translucentRenderer_->SetEnabled(true);
+    }
 }
 
 void Chunk::ChunkSection::Disable() noexcept
 {
     SetEnabled(false);
-    renderer_->SetEnabled(false);
+    if (renderer_)
+    {
+        renderer_->SetEnabled(false);
+    }
+
+    if (translucentRenderer_)
+    {
+        translucentRenderer_->SetEnabled(false);
+    }
+}
+
+void Chunk::ChunkSection::SetBlocks(std::shared_ptr<const BlockStorage> blocks)
+{
+    const SectionOccupancy occupancy = blocks ? SectionOccupancy{*blocks} : SectionOccupancy{};
+    Publish(std::move(blocks), occupancy);
+}
+
+bool Chunk::ChunkSection::SetBlock(const Vector3<int> position, const uint8_t blockId)
+{
+    const auto snapshot = GetSnapshot();
+    const int flatIndex = GetSectionFlatIndex(position);
+
+    const uint8_t previousId = snapshot->blocks ? snapshot->blocks->Get(flatIndex) : Block::Air.GetId();
+    if (previousId == blockId) return false;
+
+    // Published storages are never modified, the change is made on a copy
+    auto blocks = snapshot->blocks
+                      ? std::make_shared<BlockStorage>(*snapshot->blocks)
+                      : std::make_shared<BlockStorage>(SectionSize, Block::Air.GetId());
+    blocks->Set(flatIndex, blockId);
+
+    SectionOccupancy occupancy = snapshot->occupancy;
+    occupancy.OnBlockChanged(position.x, position.y, position.z, previousId, blockId);
+
+    Publish(occupancy.IsEmpty() ? nullptr : std::move(blocks), occupancy);
+    return true;
+}
+
+std::shared_ptr<const Chunk::ChunkSection::Snapshot> Chunk::ChunkSection::GetSnapshot() const noexcept
+{
+    return snapshot_.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<const Chunk::ChunkSection::Snapshot> Chunk::ChunkSection::GetNeighbourSnapshot(
+    const int dx, const int dy, const int dz) const
+{
+    auto snapshot = GetSnapshot();
+    if (!dag_) return snapshot;
+
+    assert(dx != 0 || dy != 0 || dz != 0);
+
+    // Only the layer towards the other section is read along every axis this section is offset on
+    const std::array min{dx < 0 ? Width - 1 : 0, dy < 0 ? SectionHeight - 1 : 0, dz < 0 ? Depth - 1 : 0};
+    const std::array max{dx > 0 ? 0 : Width - 1, dy > 0 ? 0 : SectionHeight - 1, dz > 0 ? 0 : Depth - 1};
+
+    std::array<uint8_t, SectionSize> blocks; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    dag_->ExpandRegion(archive_, min, max, blocks);
+
+    std::array<uint8_t, BorderSize> border; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    border.fill(Block::Air.GetId());
+    for (int y = min[1]; y <= max[1]; ++y)
+    {
+        for (int z = min[2]; z <= max[2]; ++z)
+        {
+            for (int x = min[0]; x <= max[0]; ++x)
+            {
+                border[GetBorderIndex(x, y, z)] = blocks[Geometry::GetSectionFlatIndex(x, y, z)];
+            }
+        }
+    }
+
+    return std::make_shared<const Snapshot>(Snapshot{
+        snapshot->version, nullptr, snapshot->occupancy, std::make_shared<const BlockStorage>(std::span{border})
+    });
+}
+
+uint64_t Chunk::ChunkSection::GetVersion() const noexcept
+{
+    return GetSnapshot()->version;
+}
+
+void Chunk::ChunkSection::Archive(VoxelDag& dag)
+{
+    const auto snapshot = GetSnapshot();
+    if (!snapshot->blocks) return;
+
+    std::array<uint8_t, SectionSize> blocks; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    snapshot->blocks->CopyTo(blocks);
+    archive_ = dag.Insert(blocks);
+    dag_ = &dag;
+
+    // Sections next to this one read its outer blocks from the DAG through GetNeighbourSnapshot
+    snapshot_.store(std::make_shared<const Snapshot>(Snapshot{snapshot->version, nullptr, snapshot->occupancy}),
+                    std::memory_order_release);
+    UpdateMemoryUsage();
+}
+
+void Chunk::ChunkSection::Restore(VoxelDag& dag)
+{
+    const auto snapshot = GetSnapshot();
+    if (snapshot->occupancy.IsEmpty()) return;
+
+    std::array<uint8_t, SectionSize> blocks; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    dag.Expand(archive_, blocks);
+    dag.Release(archive_);
+    archive_ = VoxelDag::UniformFlag;
+    dag_ = nullptr;
+
+    snapshot_.store(std::make_shared<const Snapshot>(Snapshot{
+                        snapshot->version, std::make_shared<const BlockStorage>(std::span{blocks}), snapshot->occupancy
+                    }), std::memory_order_release);
+    UpdateMemoryUsage();
+}
+
+VoxelDag::NodeRef Chunk::ChunkSection::TakeArchive() noexcept
+{
+    const VoxelDag::NodeRef archive = archive_;
+    archive_ = VoxelDag::UniformFlag;
+    dag_ = nullptr;
+    return archive;
+}
+
+void Chunk::ChunkSection::Destroy()
+{
+    assert(!HasPendingJobs());
+
+    ClearMesh();
+    if (collider_)
+    {
+        collider_->Destroy();
+        collider_ = nullptr;
+    }
+
+    renderer_ = nullptr;
+    translucentRenderer_ = nullptr;
+
+    // The mesh was already released by ClearMesh
+    chunk_.world_.UpdateResidentMemory(memoryUsage_, 0);
+    memoryUsage_ = 0;
+
+    GetGame()->DestroyActor(GetActor());
+}
+
+bool Chunk::ChunkSection::HasPendingJobs() const noexcept
+{
+    return pendingJobs_ > 0;
+}
+
+uint8_t Chunk::ChunkSection::GetBlockId(const int flatIndex) const noexcept
+{
+    const auto snapshot = GetSnapshot();
+    return snapshot->blocks ? snapshot->blocks->Get(flatIndex) : Block::Air.GetId();
+}
+
+bool Chunk::ChunkSection::IsEmpty() const noexcept
+{
+    return GetSnapshot()->occupancy.IsEmpty();
+}
+
+bool Chunk::ChunkSection::IsFull() const noexcept
+{
+    return GetSnapshot()->occupancy.IsFull();
+}
+
+size_t Chunk::ChunkSection::GetMemoryUsage() const noexcept
+{
+    const auto snapshot = GetSnapshot();
+    return snapshot->blocks ? snapshot->blocks->GetMemoryUsage() : 0;
+}
+
+size_t Chunk::ChunkSection::GetColliderMemoryUsage() const noexcept
+{
+    // The physics shapes themselves are owned by PhysX, only the boxes they are created from are counted
+    return collider_ ? collider_->GetShapeCount() * sizeof(Collider::Box) : 0;
+}
+
+void Chunk::ChunkSection::UpdateMemoryUsage()
+{
+    World& world = chunk_.world_;
+
+    const size_t usage = sizeof(ChunkSection) + GetMemoryUsage() + GetColliderMemoryUsage();
+    world.UpdateResidentMemory(memoryUsage_, usage);
+    memoryUsage_ = usage;
+
+    // Vertex buffers are shared through the mesh cache, the world counts every buffer once
+    if (vertexBuffer_.get() == countedBuffer_) return;
+
+    if (countedBuffer_)
+    {
+        world.RemoveMeshUser(countedBuffer_);
+    }
+
+    if (vertexBuffer_)
+    {
+        world.AddMeshUser(vertexBuffer_.get(), quads_.GetSlotCount() * 4 * sizeof(TerrainVertex));
+    }
+    countedBuffer_ = vertexBuffer_.get();
+}
+
+void Chunk::ChunkSection::CopyBlocks(const std::span<uint8_t> destination) const noexcept
+{
+    if (const auto snapshot = GetSnapshot(); snapshot->blocks)
+    {
+        snapshot->blocks->CopyTo(destination);
+    }
+    else
+    {
+        std::fill_n(destination.begin(), SectionSize, Block::Air.GetId());
+    }
+}
+
+void Chunk::ChunkSection::Publish(std::shared_ptr<const BlockStorage> blocks,
+                                  const SectionOccupancy& occupancy) noexcept
+{
+    // Only the main thread writes, so the version can not change between the load and the store
+    const uint64_t version = GetVersion() + 1;
+    snapshot_.store(std::make_shared<const Snapshot>(Snapshot{version, std::move(blocks), occupancy}),
+                    std::memory_order_release);
+    UpdateMemoryUsage();
 }
 
-const Block& Chunk::ChunkSection::GetBlock(const Vector3<int> position) const noexcept
+bool Chunk::ChunkSection::IsMeshStale(const uint64_t version, const uint64_t meshRequest) const noexcept
 {
-    return chunk_.GetLocalBlock({position.x, position.y + section_ * SectionHeight, position.z});
+    return meshRequest != meshRequest_ || version != GetVersion();
 }
 
 
@@ -335,11 +600,13 @@ const Block& Chunk::ChunkSection::GetBlock(const Vector3<int> position) const no
 // Chunk
 //------------------------------------------------------------------------------
 
-Chunk::Chunk(const World& world, const ChunkCoords coords)
+Chunk::Chunk(World& world, const ChunkCoords coords)
     : world_{world},
       coords_{coords},
       sections_(SectionsPerChunk)
 {
+    neighbours_[GetNeighbourIndex(0, 0, 0)] = this;
+    world_.UpdateResidentMemory(0, sizeof(Chunk));
 }
 
 void Chunk::Enable() noexcept
@@ -363,7 +630,10 @@ void Chunk::Disable() noexcept
 
 void Chunk::Start()
 {
-    GetTransform()->SetPosition({static_cast<float>(coords_.x) * Width, 0, static_cast<float>(coords_.y) * Depth});
+    GetTransform()->SetPosition({
+        static_cast<float>(coords_.x) * Width, static_cast<float>(coords_.y) * Height,
+        static_cast<float>(coords_.z) * Depth
+    });
     for (int i = 0; i < SectionsPerChunk; ++i)
     {
         const auto sectorPosition = GetTransform()->GetPosition() + Vector3<float>{
@@ -382,16 +652,28 @@ const Block& Chunk::GetWorldBlock(const Vector3<int> position) const noexcept
         // TODO: This needs to change
         return Block::Air;
     }
-    if (position.y < 0 || position.y > Height - 1) return Block::Air;
-    if (world_.ChunkCoordFromPosition(position) != coords_) return world_.GetBlock(position);
 
-    const uint8_t blockId = blocks_.value()[GetFlatIndex(position)];
+    if (const ChunkCoords coords = world_.ChunkCoordFromPosition(position); coords != coords_)
+    {
+        const int dx = coords.x - coords_.x;
+        const int dy = coords.y - coords_.y;
+        const int dz = coords.z - coords_.z;
+        if (std::abs(dx) > 1 || std::abs(dy) > 1 || std::abs(dz) > 1) return world_.GetBlock(position);
+
+        const Chunk* neighbour = GetNeighbour(dx, dy, dz);
+        return neighbour ? neighbour->GetWorldBlock(position) : Block::Air;
+    }
+
+    const int section = Geometry::GetSection(position.y - coords_.y * Height);
+    const uint8_t blockId = sections_[section]->GetBlockId(GetSectionFlatIndex(position));
     return BlockRegistry::GetBlock(blockId);
 }
 
 const Block& Chunk::GetLocalBlock(const Vector3<int> position) const noexcept
 {
-    return GetWorldBlock({position.x + coords_.x * Width, position.y, position.z + coords_.y * Depth});
+    return GetWorldBlock({
+        position.x + coords_.x * Width, position.y + coords_.y * Height, position.z + coords_.z * Depth
+    });
 }
 
 const World& Chunk::GetWorld() const noexcept
@@ -406,48 +688,464 @@ Chunk::ChunkCoords Chunk::GetCoords() const noexcept
 
 bool Chunk::IsInitialized() const noexcept
 {
-    return blocks_ != std::nullopt;
+    return isInitialized_ && !isArchived_;
+}
+
+bool Chunk::IsArchived() const noexcept
+{
+    return isArchived_;
 }
 
-void Chunk::SetBlocks(ChunkData blocks)
+void Chunk::Archive(VoxelDag& dag)
+{
+    if (!isInitialized_ || isArchived_) return;
+
+    for (const auto& section : sections_)
+    {
+        section->Archive(dag);
+    }
+    isArchived_ = true;
+}
+
+bool Chunk::Restore(VoxelDag& dag)
+{
+    if (!isArchived_) return false;
+
+    for (const auto& section : sections_)
+    {
+        section->Restore(dag);
+    }
+    isArchived_ = false;
+
+    if (deferredSections_.none()) return false;
+
+    const bool wasClean = dirtySections_.none();
+    dirtySections_ |= deferredSections_;
+    deferredSections_.reset();
+    return wasClean;
+}
+
+bool Chunk::IsModified() const noexcept
+{
+    return isModified_;
+}
+
+void Chunk::ReleaseMeshes()
+{
+    assert(isArchived_);
+
+    for (const auto& section : sections_)
+    {
+        section->ClearMesh();
+    }
+
+    // Restoring the chunk remeshes every section
+    deferredSections_.set();
+}
+
+Chunk::ArchiveRoots Chunk::TakeArchive() noexcept
+{
+    assert(isArchived_);
+
+    ArchiveRoots roots{};
+    for (int i = 0; i < SectionsPerChunk; ++i)
+    {
+        roots[i] = sections_[i]->TakeArchive();
+    }
+    return roots;
+}
+
+void Chunk::Destroy()
+{
+    for (const auto& section : sections_)
+    {
+        section->Destroy();
+    }
+    world_.UpdateResidentMemory(sizeof(Chunk), 0);
+    GetGame()->DestroyActor(GetActor());
+}
+
+bool Chunk::HasPendingJobs() const noexcept
+{
+    return std::ranges::any_of(sections_, [](const auto& section) { return section->HasPendingJobs(); });
+}
+
+int Chunk::GetSurfaceHeight(const int x, const int z) const noexcept
+{
+    return heightmap_[x + z * Width];
+}
+
+size_t Chunk::GetMemoryUsage() const noexcept
+{
+    size_t usage = sizeof(Chunk);
+    for (const auto& section : sections_)
+    {
+        usage += sizeof(ChunkSection) + section->GetMemoryUsage();
+    }
+    return usage;
+}
+
+void Chunk::SetBlocks(const ChunkData& blocks, const bool isModified)
+{
+    SectionData sections = SplitIntoSections(blocks);
+    for (int i = 0; i < SectionsPerChunk; ++i)
+    {
+        sections_[i]->SetBlocks(std::move(sections[i]));
+    }
+
+    for (int z = 0; z < Depth; ++z)
+    {
+        for (int x = 0; x < Width; ++x)
+        {
+            heightmap_[x + z * Width] = static_cast<int16_t>(FindSurfaceHeight(x, z));
+        }
+    }
+
+    isInitialized_ = true;
+    isModified_ = isModified;
+}
+
+bool Chunk::SetLocalBlock(const Vector3<int> position, const uint8_t blockId)
+{
+    const int section = Geometry::GetSection(position.y);
+    if (!sections_[section]->SetBlock({position.x, position.y & (SectionHeight - 1), position.z}, blockId))
+    {
+        return false;
+    }
+    isModified_ = true;
+
+    // Placing a block can only raise the surface, removing the top block requires a search for the next one below
+    int16_t& height = heightmap_[position.x + position.z * Width];
+    if (blockId != Block::Air.GetId())
+    {
+        height = std::max(height, static_cast<int16_t>(position.y + 1));
+    }
+    else if (position.y + 1 == height)
+    {
+        height = static_cast<int16_t>(FindSurfaceHeight(position.x, position.z));
+    }
+
+    return true;
+}
+
+bool Chunk::EditSection(const int section, const Vector3<int> min, const Vector3<int> max, const RowEdit& edit)
+{
+    std::array<uint8_t, SectionSize> blocks; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    sections_[section]->CopyBlocks(blocks);
+
+    // Rows along the X axis are only contiguous in the linear layout, other layouts are edited in a linear copy
+    constexpr bool isLinear = std::is_same_v<Geometry::BlockLayout, LinearLayout>;
+    std::array<uint8_t, isLinear ? 0 : SectionSize> linearCopy; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    const auto getLinearIndex = [](const int x, const int y, const int z) { return x + (z + y * Depth) * Width; };
+    std::span<uint8_t> rows = blocks;
+
+    if constexpr (!isLinear)
+    {
+        for (int y = 0; y < SectionHeight; ++y)
+        {
+            for (int z = 0; z < Depth; ++z)
+            {
+                for (int x = 0; x < Width; ++x)
+                {
+                    linearCopy[getLinearIndex(x, y, z)] = blocks[Geometry::GetSectionFlatIndex(x, y, z)];
+                }
+            }
+        }
+        rows = linearCopy;
+    }
+
+    bool changed = false;
+    for (int y = min.y; y <= max.y; ++y)
+    {
+        for (int z = min.z; z <= max.z; ++z)
+        {
+            const Vector3<int> start{
+                coords_.x * Width + min.x, coords_.y * Height + section * SectionHeight + y, coords_.z * Depth + z
+            };
+            changed |= edit(rows.subspan(getLinearIndex(min.x, y, z), max.x - min.x + 1), start);
+        }
+    }
+
+    if (!changed) return false;
+    isModified_ = true;
+
+    if constexpr (!isLinear)
+    {
+        for (int y = 0; y < SectionHeight; ++y)
+        {
+            for (int z = 0; z < Depth; ++z)
+            {
+                for (int x = 0; x < Width; ++x)
+                {
+                    blocks[Geometry::GetSectionFlatIndex(x, y, z)] = linearCopy[getLinearIndex(x, y, z)];
+                }
+            }
+        }
+    }
+
+    const bool isEmpty = std::ranges::all_of(blocks, [](const uint8_t blockId)
+    {
+        return blockId == Block::Air.GetId();
+    });
+    sections_[section]->SetBlocks(isEmpty ? nullptr : std::make_shared<const BlockStorage>(std::span{blocks}));
+
+    for (int z = min.z; z <= max.z; ++z)
+    {
+        for (int x = min.x; x <= max.x; ++x)
+        {
+            heightmap_[x + z * Width] = static_cast<int16_t>(FindSurfaceHeight(x, z));
+        }
+    }
+
+    return true;
+}
+
+void Chunk::CopySectionBlocks(const int section, const std::span<uint8_t> destination) const noexcept
+{
+    sections_[section]->CopyBlocks(destination);
+}
+
+void Chunk::SetNeighbour(const int dx, const int dy, const int dz, Chunk* neighbour) noexcept
+{
+    assert(std::abs(dx) <= 1 && std::abs(dy) <= 1 && std::abs(dz) <= 1 && (dx != 0 || dy != 0 || dz != 0));
+    neighbours_[GetNeighbourIndex(dx, dy, dz)] = neighbour;
+}
+
+const Chunk* Chunk::GetNeighbour(const int dx, const int dy, const int dz) const noexcept
+{
+    return neighbours_[GetNeighbourIndex(dx, dy, dz)];
+}
+
+Chunk::SectionNeighbourhood Chunk::GetSectionNeighbourhood(const int section) const
+{
+    SectionNeighbourhood neighbourhood{};
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dz = -1; dz <= 1; ++dz)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                if (const ChunkSection* neighbour = GetNeighbourSection(section, dx, dy, dz))
+                {
+                    neighbourhood[GetNeighbourhoodIndex(dx, dy, dz)] = neighbour->GetNeighbourSnapshot(dx, dy, dz);
+                }
+            }
+        }
+    }
+    return neighbourhood;
+}
+
+Chunk::SectionData Chunk::SplitIntoSections(const ChunkData& blocks)
 {
     assert(blocks.size() == Size);
-    blocks_ = std::move(blocks);
+
+    SectionData sections{};
+
+    // Blocks are stored with y varying slowest, so every section is a contiguous range of the chunk
+    for (int section = 0; section < SectionsPerChunk; ++section)
+    {
+        const auto sectionBlocks = std::span{blocks}.subspan(static_cast<size_t>(section) * SectionSize, SectionSize);
+
+        if (std::ranges::any_of(sectionBlocks, [](const uint8_t blockId) { return blockId != Block::Air.GetId(); }))
+        {
+            sections[section] = std::make_unique<BlockStorage>(sectionBlocks);
+        }
+    }
+
+    return sections;
+}
+
+void Chunk::CopySectionVolume(const SectionNeighbourhood& neighbourhood, SectionVolume& volume) noexcept
+{
+    // Decode the section itself in storage order and scatter it into the interior of the volume
+    std::array<uint8_t, SectionSize> blocks; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    if (const auto& center = neighbourhood[GetNeighbourhoodIndex(0, 0, 0)]->blocks)
+    {
+        center->CopyTo(blocks);
+    }
+    else
+    {
+        blocks.fill(Block::Air.GetId());
+    }
+
+    for (int y = 0; y < SectionHeight; ++y)
+    {
+        for (int z = 0; z < Depth; ++z)
+        {
+            for (int x = 0; x < Width; ++x)
+            {
+                volume.Set(x, y, z, blocks[Geometry::GetSectionFlatIndex(x, y, z)]);
+            }
+        }
+    }
+
+    // Only the border is read from the surrounding sections
+    for (int y = -1; y <= SectionHeight; ++y)
+    {
+        const bool isBorderLayer = y < 0 || y == SectionHeight;
+        for (int z = -1; z <= Depth; ++z)
+        {
+            const bool isBorderRow = isBorderLayer || z < 0 || z == Depth;
+
+            // Inside of the section only the first and last block of a row belong to the border
+            const int step = isBorderRow ? 1 : Width + 1;
+            for (int x = -1; x <= Width; x += step)
+            {
+                volume.Set(x, y, z, GetNeighbourhoodBlock(neighbourhood, x, y, z));
+            }
+        }
+    }
+}
+
+uint8_t Chunk::GetNeighbourhoodBlock(const SectionNeighbourhood& neighbourhood, const int x, const int y,
+                                     const int z) noexcept
+{
+    const auto& snapshot = neighbourhood[GetNeighbourhoodIndex(
+        Geometry::GetChunkX(x), Geometry::GetSection(y), Geometry::GetChunkZ(z))];
+
+    if (!snapshot) return Block::Air.GetId();
+    if (snapshot->blocks) return snapshot->blocks->Get(Geometry::GetSectionFlatIndex(x, y, z));
+
+    // The coordinates wrap into the neighbour, where they lie on one of its outer faces
+    if (snapshot->border)
+    {
+        return snapshot->border->Get(GetBorderIndex(x & (Width - 1), y & (SectionHeight - 1), z & (Depth - 1)));
+    }
+    return Block::Air.GetId();
+}
+
+std::unique_ptr<DispatchWorkGroup> Chunk::RegenerateMesh()
+{
+    return RegenerateSections(SectionMask{}.set());
+}
+
+bool Chunk::PatchSection(const int section, const Vector3<int> position)
+{
+    // Sections that wait for a mesh job or are not meshed at the moment are remeshed as a whole
+    if (isArchived_ || dirtySections_.test(section) || deferredSections_.test(section))
+    {
+        return false;
+    }
+
+    // Sections that became empty have their mesh cleared by the regular path
+    if (sections_[section]->IsEmpty()) return false;
+
+    // A patch places full resolution faces, which would not match the cells of a lower level of detail. The border
+    // levels include the level of this chunk.
+    if (std::ranges::any_of(GetBorderLevels(), [](const int level) { return level != 0; })) return false;
+
+    return sections_[section]->PatchMesh(position);
+}
+
+int Chunk::GetLevelOfDetail() const noexcept
+{
+    return levelOfDetail_;
 }
 
-inline int Chunk::GetFlatIndex(Vector3<int> position)
+bool Chunk::SetLevelOfDetail(const int level) noexcept
 {
-    static constexpr auto MaxSize = Vector3{Width, Height, Depth};
-    // TODO: can this be optimized?
-    position = position % MaxSize;
-    if (position.x < 0) position.x += Width;
-    if (position.y < 0) position.y += Height;
-    if (position.z < 0) position.z += Depth;
+    assert(level >= 0 && level < SectionLevelOfDetail::LevelCount);
 
+    if (level == levelOfDetail_) return false;
+    levelOfDetail_ = level;
+    return true;
+}
+
+Chunk::SectionLevelOfDetail::BorderLevels Chunk::GetBorderLevels() const noexcept
+{
+    SectionLevelOfDetail::BorderLevels borderLevels{};
+    for (int face = 0; face < ChunkMeshData::FaceCount; ++face)
+    {
+        const auto [axis, sign] = ChunkMeshData::FaceDirections[face];
+        const Chunk* neighbour = GetNeighbour(axis == 0 ? sign : 0, axis == 1 ? sign : 0, axis == 2 ? sign : 0);
+        borderLevels[face] = neighbour ? neighbour->levelOfDetail_ : levelOfDetail_;
+    }
+    return borderLevels;
+}
 
-    return position.x + Width * (position.y + Height * position.z);
+bool Chunk::MarkSectionDirty(const int section) noexcept
+{
+    const bool wasClean = dirtySections_.none();
+    dirtySections_.set(section);
+    return wasClean;
 }
 
-int Chunk::GetFlatIndex(const int x, const int y, const int z)
+std::unique_ptr<DispatchWorkGroup> Chunk::RegenerateDirtySections()
 {
-    return GetFlatIndex({x, y, z});
+    const SectionMask dirtySections = dirtySections_;
+    dirtySections_.reset();
+    return RegenerateSections(dirtySections);
 }
 
-std::unique_ptr<DispatchWorkGroup> Chunk::RegenerateMesh() const
+std::unique_ptr<DispatchWorkGroup> Chunk::RegenerateSections(const SectionMask sections)
 {
     auto workGroup = std::make_unique<DispatchWorkGroup>();
+
+    // The meshes of an archived chunk are kept, its blocks are not available for meshing
+    if (isArchived_)
+    {
+        deferredSections_ |= sections;
+        return workGroup;
+    }
+
     for (int i = 0; i < SectionsPerChunk; ++i)
     {
+        if (!sections.test(i)) continue;
+
+        // Empty sections have nothing to mesh and the faces of hidden sections can not be seen
+        if (sections_[i]->IsEmpty() || IsSectionHidden(i))
+        {
+            sections_[i]->ClearMesh();
+            continue;
+        }
+
         workGroup->AddWorkItem(sections_[i]->RegenerateMesh(), DispatchQueue::Background());
     }
     return workGroup;
 }
 
+bool Chunk::IsSectionHidden(const int section) const noexcept
+{
+    if (!sections_[section]->IsFull()) return false;
+
+    // Faces towards chunks that are not loaded are always visible
+    return std::ranges::all_of(ChunkMeshData::FaceDirections, [this, section](const auto direction)
+    {
+        const auto [axis, sign] = direction;
+        const ChunkSection* neighbour = GetNeighbourSection(section, axis == 0 ? sign : 0, axis == 1 ? sign : 0,
+                                                            axis == 2 ? sign : 0);
+        return neighbour && neighbour->IsFull();
+    });
+}
+
+const Chunk::ChunkSection* Chunk::GetNeighbourSection(const int section, const int dx, const int dy,
+                                                      const int dz) const noexcept
+{
+    // Sections above the top or below the bottom of this chunk lie in the chunk above or below
+    const int index = section + dy;
+    const int chunkDy = index < 0 ? -1 : index >= SectionsPerChunk ? 1 : 0;
+
+    const Chunk* chunk = GetNeighbour(dx, chunkDy, dz);
+    return chunk ? chunk->sections_[index - chunkDy * SectionsPerChunk].get() : nullptr;
+}
+
+int Chunk::FindSurfaceHeight(const int x, const int z) const noexcept
+{
+    for (int section = SectionsPerChunk - 1; section >= 0; --section)
+    {
+        if (const int highest = sections_[section]->GetSnapshot()->occupancy.GetHighestBlock(x, z); highest >= 0)
+        {
+            return section * SectionHeight + highest + 1;
+        }
+    }
+    return 0;
+}
+
 namespace Blocks
 {
     std::ostream& operator<<(std::ostream& out, const Chunk& chunk)
     {
-        out << chunk.coords_.x << ", " << chunk.coords_.y;
+        out << chunk.coords_.x << ", " << chunk.coords_.y << ", " << chunk.coords_.z;
         return out;
     }
 }
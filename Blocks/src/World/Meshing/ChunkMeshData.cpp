@@ -0,0 +1,128 @@
+﻿#include "Blocks/pch.h"
+#include "Blocks/World/Meshing/ChunkMeshData.h"
+
+#include "Blocks/World/BlockRegistry.h"
+
+using namespace Blocks;
+using namespace BlocksEngine;
+
+void ChunkMeshData::Clear() noexcept
+{
+    vertices.clear();
+}
+
+void ChunkMeshData::Reserve(const size_t quadCount)
+{
+    vertices.reserve(vertices.size() + quadCount * 4);
+}
+
+namespace
+{
+    /**
+     * \brief The offset of a vertex from the corner of its quad, packed like the first word of a TerrainVertex.
+     * Every field of a vertex grows linearly with the width and the height of the quad and stays far below the next
+     * field, so the packed offset is the sum of the packed offsets per unit of width and of height.
+     */
+    struct CornerOffset
+    {
+        uint32_t perWidth;
+        uint32_t perHeight;
+    };
+
+    using QuadCorners = std::array<CornerOffset, 4>;
+
+    /**
+     * \brief The packed offsets of the four vertices of a quad.
+     * \param axis The axis the quad faces: 0 for X, 1 for Y and 2 for Z.
+     * \param flipped Whether the face points towards the negative axis.
+     * \param width, height The size of the quad, 1 and 0 or 0 and 1 for the offsets per unit.
+     */
+    constexpr std::array<uint32_t, 4> GetCornerOffsets(const int axis, const bool flipped, const int width,
+                                                      const int height)
+    {
+        const int u = (axis + 1) % 3;
+        const int v = (axis + 2) % 3;
+
+        // Determine the size and orientation of this face
+        int du[3] = {0, 0, 0};
+        int dv[3] = {0, 0, 0};
+
+        const bool flipUvs = axis == 0 ? !flipped : flipped;
+
+        if (!flipped)
+        {
+            dv[v] = height;
+            du[u] = width;
+        }
+        else
+        {
+            du[v] = height;
+            dv[u] = width;
+        }
+
+        const int uv[2] = {axis == 0 ? width : height, axis == 0 ? height : width};
+
+        const auto pack = [](const int vx, const int vy, const int vz, const int u, const int v)
+        {
+            return TerrainVertex(vx, vy, vz, u, v, 0, 0).data;
+        };
+
+        // The order of the vertices has to match the triangles of IndexBuffer::GetQuadList
+        return {
+            pack(0, 0, 0, flipUvs ? 0 : uv[1], uv[0]),
+            pack(du[0], du[1], du[2], 0, flipUvs ? 0 : uv[0]),
+            pack(dv[0], dv[1], dv[2], uv[1], flipUvs ? uv[0] : 0),
+            pack(du[0] + dv[0], du[1] + dv[1], du[2] + dv[2], flipUvs ? uv[1] : 0, 0)
+        };
+    }
+
+    // Indexed by the axis of a quad and whether it is flipped
+    constexpr std::array<std::array<QuadCorners, 2>, 3> Corners = []
+    {
+        std::array<std::array<QuadCorners, 2>, 3> corners{};
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            for (const bool flipped : {false, true})
+            {
+                const std::array<uint32_t, 4> perWidth = GetCornerOffsets(axis, flipped, 1, 0);
+                const std::array<uint32_t, 4> perHeight = GetCornerOffsets(axis, flipped, 0, 1);
+                for (int corner = 0; corner < 4; ++corner)
+                {
+                    corners[axis][flipped][corner] = {perWidth[corner], perHeight[corner]};
+                }
+            }
+        }
+        return corners;
+    }();
+}
+
+void ChunkMeshData::AddQuad(const int axis, const std::array<int, 3> position, const int width, const int height,
+                            const int blockId)
+{
+    AddQuad({
+        static_cast<uint8_t>(axis),
+        {static_cast<uint8_t>(position[0]), static_cast<uint8_t>(position[1]), static_cast<uint8_t>(position[2])},
+        static_cast<uint8_t>(width),
+        static_cast<uint8_t>(height),
+        static_cast<int16_t>(blockId)
+    });
+}
+
+void ChunkMeshData::AddQuad(const MeshQuad& quad)
+{
+    const bool flipped = quad.blockId < 0;
+    const int faceId = GetFace(quad);
+    const uint32_t texture = BlockRegistry::GetTextureTable()[flipped ? -quad.blockId : quad.blockId][faceId];
+
+    // The other vertices only add their offsets to the corner with the lowest coordinates
+    const TerrainVertex corner{
+        quad.position[0], quad.position[1], quad.position[2], 0, 0, static_cast<uint32_t>(faceId), texture
+    };
+
+    for (const CornerOffset& offset : Corners[quad.axis][flipped])
+    {
+        TerrainVertex vertex = corner;
+        vertex.data += offset.perWidth * quad.width + offset.perHeight * quad.height;
+        vertices.push_back(vertex);
+    }
+}
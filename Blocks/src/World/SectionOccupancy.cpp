@@ -0,0 +1,89 @@
+﻿#include "Blocks/pch.h"
+#include "Blocks/World/SectionOccupancy.h"
+
+#include <bit>
+
+#include "Blocks/World/Block.h"
+#include "Blocks/World/BlockRegistry.h"
+#include "Blocks/World/BlockStorage.h"
+
+using namespace Blocks;
+
+SectionOccupancy::SectionOccupancy(const BlockStorage& blocks)
+{
+    // Looking up every distinct block once is enough
+    std::array<bool, 256> isOpaque{};
+    for (const uint8_t blockId : blocks.GetPalette())
+    {
+        isOpaque[blockId] = IsOpaque(blockId);
+    }
+
+    std::array<uint8_t, Geometry::SectionSize> blockIds; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    blocks.CopyTo(blockIds);
+
+    for (int y = 0; y < Geometry::SectionHeight; ++y)
+    {
+        for (int z = 0; z < Geometry::Depth; ++z)
+        {
+            for (int x = 0; x < Geometry::Width; ++x)
+            {
+                const uint8_t blockId = blockIds[Geometry::GetSectionFlatIndex(x, y, z)];
+                if (blockId == Block::Air.GetId()) continue;
+
+                ++nonAirCount_;
+                opaqueCount_ += isOpaque[blockId];
+                columns_[GetColumnIndex(x, z)] |= static_cast<ColumnMask>(ColumnMask{1} << y);
+            }
+        }
+    }
+}
+
+void SectionOccupancy::OnBlockChanged(const int x, const int y, const int z, const uint8_t previousId,
+                                      const uint8_t blockId)
+{
+    if (previousId == blockId) return;
+
+    const bool wasAir = previousId == Block::Air.GetId();
+    const bool isAir = blockId == Block::Air.GetId();
+    nonAirCount_ += static_cast<int>(wasAir) - static_cast<int>(isAir);
+    opaqueCount_ += static_cast<int>(IsOpaque(blockId)) - static_cast<int>(IsOpaque(previousId));
+
+    const auto bit = static_cast<ColumnMask>(ColumnMask{1} << y);
+    ColumnMask& column = columns_[GetColumnIndex(x, z)];
+    column = isAir ? static_cast<ColumnMask>(column & ~bit) : static_cast<ColumnMask>(column | bit);
+}
+
+int SectionOccupancy::GetNonAirCount() const noexcept
+{
+    return nonAirCount_;
+}
+
+int SectionOccupancy::GetOpaqueCount() const noexcept
+{
+    return opaqueCount_;
+}
+
+bool SectionOccupancy::IsEmpty() const noexcept
+{
+    return nonAirCount_ == 0;
+}
+
+bool SectionOccupancy::IsFull() const noexcept
+{
+    return opaqueCount_ == Geometry::SectionSize;
+}
+
+SectionOccupancy::ColumnMask SectionOccupancy::GetColumnMask(const int x, const int z) const noexcept
+{
+    return columns_[GetColumnIndex(x, z)];
+}
+
+int SectionOccupancy::GetHighestBlock(const int x, const int z) const noexcept
+{
+    return static_cast<int>(std::bit_width(GetColumnMask(x, z))) - 1;
+}
+
+bool SectionOccupancy::IsOpaque(const uint8_t blockId)
+{
+    return !BlockRegistry::GetBlock(blockId).IsSeeThrough();
+}
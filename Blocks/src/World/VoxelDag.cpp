@@ -0,0 +1,259 @@
+﻿#include "Blocks/pch.h"
+#include "Blocks/World/VoxelDag.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace Blocks;
+
+VoxelDag::NodeRef VoxelDag::Insert(const std::span<const uint8_t> blocks)
+{
+    assert(blocks.size() == Geometry::SectionSize);
+    return Build(blocks, 0, 0, 0, Geometry::Width);
+}
+
+void VoxelDag::Expand(const NodeRef root, const std::span<uint8_t> blocks) const noexcept
+{
+    assert(blocks.size() == Geometry::SectionSize);
+    ExpandNode(root, blocks, 0, 0, 0, Geometry::Width);
+}
+
+void VoxelDag::ExpandRegion(const NodeRef root, const std::array<int, 3> min, const std::array<int, 3> max,
+                            const std::span<uint8_t> blocks) const noexcept
+{
+    assert(blocks.size() == Geometry::SectionSize);
+    ExpandRegionNode(root, min, max, blocks, 0, 0, 0, Geometry::Width);
+}
+
+void VoxelDag::Release(const NodeRef root) noexcept
+{
+    if (IsUniform(root)) return;
+
+    Node& node = nodes_[root];
+    if (--node.refCount > 0) return;
+
+    TableErase(root);
+    for (const NodeRef child : node.children)
+    {
+        Release(child);
+    }
+    freeNodes_.push_back(root);
+}
+
+size_t VoxelDag::GetNodeCount() const noexcept
+{
+    return nodes_.size() - freeNodes_.size();
+}
+
+size_t VoxelDag::GetMemoryUsage() const noexcept
+{
+    return sizeof(VoxelDag) + nodes_.capacity() * sizeof(Node)
+        + (freeNodes_.capacity() + table_.capacity()) * sizeof(NodeRef);
+}
+
+size_t VoxelDag::GetUsedMemory() const noexcept
+{
+    // Every node in use also occupies a slot of the deduplication table
+    return GetNodeCount() * (sizeof(Node) + sizeof(NodeRef));
+}
+
+VoxelDag::NodeRef VoxelDag::Build(const std::span<const uint8_t> blocks, const int x, const int y, const int z,
+                                  const int size)
+{
+    if (size == 1)
+    {
+        return UniformFlag | blocks[Geometry::GetSectionFlatIndex(x, y, z)];
+    }
+
+    const int half = size / 2;
+    Children children; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    for (int i = 0; i < 8; ++i)
+    {
+        children[i] = Build(blocks, x + (i & 1) * half, y + (i >> 1 & 1) * half, z + (i >> 2 & 1) * half, half);
+    }
+
+    // A subtree with a single block id does not need a node
+    if (IsUniform(children[0]) && std::ranges::all_of(children, [&children](const NodeRef child)
+    {
+        return child == children[0];
+    }))
+    {
+        return children[0];
+    }
+
+    return Share(children);
+}
+
+VoxelDag::NodeRef VoxelDag::Share(const Children& children)
+{
+    if (const NodeRef existing = Find(children); existing != EmptySlot)
+    {
+        // The existing node already holds references to its children
+        for (const NodeRef child : children)
+        {
+            Release(child);
+        }
+
+        ++nodes_[existing].refCount;
+        return existing;
+    }
+
+    NodeRef ref;
+    if (freeNodes_.empty())
+    {
+        ref = static_cast<NodeRef>(nodes_.size());
+        nodes_.push_back({children, 1});
+    }
+    else
+    {
+        ref = freeNodes_.back();
+        freeNodes_.pop_back();
+        nodes_[ref] = {children, 1};
+    }
+
+    assert(!IsUniform(ref));
+    TableInsert(ref);
+    return ref;
+}
+
+void VoxelDag::ExpandNode(const NodeRef ref, const std::span<uint8_t> blocks, const int x, const int y, const int z,
+                          const int size) const noexcept
+{
+    if (IsUniform(ref))
+    {
+        const auto blockId = static_cast<uint8_t>(ref & ~UniformFlag);
+        for (int j = y; j < y + size; ++j)
+        {
+            for (int k = z; k < z + size; ++k)
+            {
+                for (int i = x; i < x + size; ++i)
+                {
+                    blocks[Geometry::GetSectionFlatIndex(i, j, k)] = blockId;
+                }
+            }
+        }
+        return;
+    }
+
+    const int half = size / 2;
+    const Children& children = nodes_[ref].children;
+    for (int i = 0; i < 8; ++i)
+    {
+        ExpandNode(children[i], blocks, x + (i & 1) * half, y + (i >> 1 & 1) * half, z + (i >> 2 & 1) * half, half);
+    }
+}
+
+void VoxelDag::ExpandRegionNode(const NodeRef ref, const std::array<int, 3>& min, const std::array<int, 3>& max,
+                                const std::span<uint8_t> blocks, const int x, const int y, const int z,
+                                const int size) const noexcept
+{
+    // Separate from ExpandNode, so expanding whole sections does not pay for the bounds of the region
+    if (x > max[0] || y > max[1] || z > max[2] || x + size <= min[0] || y + size <= min[1] || z + size <= min[2])
+    {
+        return;
+    }
+
+    if (IsUniform(ref))
+    {
+        const auto blockId = static_cast<uint8_t>(ref & ~UniformFlag);
+        for (int j = std::max(y, min[1]); j <= std::min(y + size - 1, max[1]); ++j)
+        {
+            for (int k = std::max(z, min[2]); k <= std::min(z + size - 1, max[2]); ++k)
+            {
+                for (int i = std::max(x, min[0]); i <= std::min(x + size - 1, max[0]); ++i)
+                {
+                    blocks[Geometry::GetSectionFlatIndex(i, j, k)] = blockId;
+                }
+            }
+        }
+        return;
+    }
+
+    const int half = size / 2;
+    const Children& children = nodes_[ref].children;
+    for (int i = 0; i < 8; ++i)
+    {
+        ExpandRegionNode(children[i], min, max, blocks, x + (i & 1) * half, y + (i >> 1 & 1) * half,
+                         z + (i >> 2 & 1) * half, half);
+    }
+}
+
+size_t VoxelDag::Hash(const Children& children) noexcept
+{
+    // FNV-1a over the child references
+    uint64_t hash = 14695981039346656037ull;
+    for (const NodeRef child : children)
+    {
+        hash = (hash ^ child) * 1099511628211ull;
+    }
+    return static_cast<size_t>(hash ^ hash >> 32);
+}
+
+VoxelDag::NodeRef VoxelDag::Find(const Children& children) const noexcept
+{
+    if (table_.empty()) return EmptySlot;
+
+    const size_t mask = table_.size() - 1;
+    for (size_t slot = Hash(children) & mask; table_[slot] != EmptySlot; slot = (slot + 1) & mask)
+    {
+        if (nodes_[table_[slot]].children == children) return table_[slot];
+    }
+    return EmptySlot;
+}
+
+void VoxelDag::TableInsert(const NodeRef ref)
+{
+    // Keep the table at most half full so probe sequences stay short
+    if ((tableCount_ + 1) * 2 > table_.size())
+    {
+        std::vector<NodeRef> previous = std::move(table_);
+        table_.assign(std::max<size_t>(previous.size() * 2, 64), EmptySlot);
+        tableCount_ = 0;
+
+        for (const NodeRef node : previous)
+        {
+            if (node != EmptySlot)
+            {
+                TableInsert(node);
+            }
+        }
+    }
+
+    const size_t mask = table_.size() - 1;
+    size_t slot = Hash(nodes_[ref].children) & mask;
+    while (table_[slot] != EmptySlot)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    table_[slot] = ref;
+    ++tableCount_;
+}
+
+void VoxelDag::TableErase(const NodeRef ref) noexcept
+{
+    const size_t mask = table_.size() - 1;
+    size_t slot = Hash(nodes_[ref].children) & mask;
+    while (table_[slot] != ref)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    // Shift the following entries of the probe sequence back so no lookup stops at the freed slot
+    size_t next = slot;
+    while (true)
+    {
+        next = (next + 1) & mask;
+        if (table_[next] == EmptySlot) break;
+
+        const size_t home = Hash(nodes_[table_[next]].children) & mask;
+        const bool staysBehindGap = slot <= next ? slot < home && home <= next : slot < home || home <= next;
+        if (staysBehindGap) continue;
+
+        table_[slot] = table_[next];
+        slot = next;
+    }
+
+    table_[slot] = EmptySlot;
+    --tableCount_;
+}
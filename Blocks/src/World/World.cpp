@@ -1,10 +1,15 @@
 ﻿#include "Blocks/pch.h"
 #include "Blocks/World/World.h"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
 #include <shared_mutex>
 #include <boost/log/trivial.hpp>
 #include <FastNoise/FastNoise.h>
 
+#include "Blocks/World/Meshing/BinaryMesher.h"
 #include "BlocksEngine/Core/Actor.h"
 #include "BlocksEngine/Core/Dispatch/DispatchQueue.h"
 #include "BlocksEngine/Core/Dispatch/DispatchWorkGroup.h"
@@ -14,10 +19,105 @@ using namespace Blocks;
 using namespace BlocksEngine;
 
 World::World(std::weak_ptr<Transform> playerTransform,
-             const uint8_t chunkLoadDistance)
+             const uint8_t chunkLoadDistance,
+             const uint8_t verticalViewDistance,
+             std::shared_ptr<const Chunk::SectionMesher> mesher,
+             const uint8_t detailDistance,
+             const size_t maxResidentChunks,
+             const size_t maxResidentBytes,
+             const size_t maxEvictedBytes)
     : chunkViewDistance_{chunkLoadDistance},
+      verticalViewDistance_{verticalViewDistance},
+      detailDistance_{detailDistance},
+      mesher_{mesher ? std::move(mesher) : std::make_shared<BinaryMesher<Chunk::Geometry>>()},
+      maxResidentChunks_{maxResidentChunks},
+      maxResidentBytes_{maxResidentBytes},
+      maxEvictedBytes_{maxEvictedBytes},
       playerTransform_{std::move(playerTransform)}
 {
+    const int radius = chunkViewDistance_;
+    const int verticalRadius = verticalViewDistance_;
+    for (int y = -verticalRadius; y <= verticalRadius; ++y)
+    {
+        for (int z = -radius; z <= radius; ++z)
+        {
+            for (int x = -radius; x <= radius; ++x)
+            {
+                if (IsWithinView({x, y, z}, Chunk::ChunkCoords::Zero, radius, verticalRadius))
+                {
+                    viewOffsets_.emplace_back(x, y, z);
+                }
+            }
+        }
+    }
+
+    // Shells of increasing distance, each one ordered by the angle around the player and then from the bottom up
+    std::ranges::sort(viewOffsets_, [](const Chunk::ChunkCoords a, const Chunk::ChunkCoords b)
+    {
+        const int distanceA = a.x * a.x + a.y * a.y + a.z * a.z;
+        const int distanceB = b.x * b.x + b.y * b.y + b.z * b.z;
+        if (distanceA != distanceB) return distanceA < distanceB;
+
+        const float angleA = std::atan2(static_cast<float>(a.z), static_cast<float>(a.x));
+        const float angleB = std::atan2(static_cast<float>(b.z), static_cast<float>(b.x));
+        if (angleA != angleB) return angleA < angleB;
+
+        return a.y < b.y;
+    });
+
+    // Every step only changes thin slices of the view, so they are found once here instead of at every update
+    const int outerRadius = radius + ViewHysteresis;
+    const int outerVerticalRadius = verticalRadius + ViewHysteresis;
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dz = -1; dz <= 1; ++dz)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                if (dx == 0 && dy == 0 && dz == 0) continue;
+
+                const Chunk::ChunkCoords move{dx, dy, dz};
+                MoveOffsets& offsets = moveOffsets_[GetMoveIndex(move)];
+
+                for (const Chunk::ChunkCoords offset : viewOffsets_)
+                {
+                    if (!IsWithinView(offset + move, Chunk::ChunkCoords::Zero, radius, verticalRadius))
+                    {
+                        offsets.entering.push_back(offset);
+                    }
+                }
+
+                for (int y = -outerVerticalRadius; y <= outerVerticalRadius; ++y)
+                {
+                    for (int z = -outerRadius; z <= outerRadius; ++z)
+                    {
+                        for (int x = -outerRadius; x <= outerRadius; ++x)
+                        {
+                            const Chunk::ChunkCoords offset{x, y, z};
+                            if (!IsWithinView(offset, Chunk::ChunkCoords::Zero, outerRadius, outerVerticalRadius))
+                            {
+                                continue;
+                            }
+
+                            if (!IsWithinView({x - dx, y - dy, z - dz}, Chunk::ChunkCoords::Zero, outerRadius,
+                                              outerVerticalRadius))
+                            {
+                                offsets.leaving.push_back(offset);
+                            }
+
+                            // The same offset relative to the new chunk of the player was at offset + move before
+                            if (IsWithinView(offset + move, Chunk::ChunkCoords::Zero, outerRadius, outerVerticalRadius)
+                                && GetLevelOfDetail(offset, Chunk::ChunkCoords::Zero)
+                                != GetLevelOfDetail(offset + move, Chunk::ChunkCoords::Zero))
+                            {
+                                offsets.levelChanges.push_back(offset);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
 }
 
 void World::Start()
@@ -32,6 +132,8 @@ void World::Start()
 
 void World::Update()
 {
+    RemeshDirtySections();
+
     const auto transform = playerTransform_.lock();
     if (!transform) return;
     const Chunk::ChunkCoords chunkCoords = ChunkCoordFromPosition(transform->GetPosition());
@@ -48,12 +150,38 @@ void World::SetPlayerTransform(std::shared_ptr<Transform> playerTransform) noexc
     playerTransform_ = std::move(playerTransform);
 }
 
-Vector2<int> World::ChunkCoordFromPosition(
+Chunk::ChunkCoords World::ChunkCoordFromPosition(
     const Vector3<float>& position) const noexcept
 {
     int x = static_cast<int>(std::floor(position.x / Chunk::Width));
+    int y = static_cast<int>(std::floor(position.y / Chunk::Height));
     int z = static_cast<int>(std::floor(position.z / Chunk::Depth));
-    return {x, z};
+    return {x, y, z};
+}
+
+Chunk::ChunkCoords World::ChunkCoordFromPosition(const Vector3<int> position) const noexcept
+{
+    return {
+        Chunk::Geometry::GetChunkX(position.x), Chunk::Geometry::GetChunkY(position.y),
+        Chunk::Geometry::GetChunkZ(position.z)
+    };
+}
+
+Chunk::SectionCoords World::SectionCoordFromPosition(const Vector3<float>& position) const noexcept
+{
+    return SectionCoordFromPosition(Vector3<int>{
+        static_cast<int>(std::floor(position.x)),
+        static_cast<int>(std::floor(position.y)),
+        static_cast<int>(std::floor(position.z))
+    });
+}
+
+Chunk::SectionCoords World::SectionCoordFromPosition(const Vector3<int> position) const noexcept
+{
+    return {
+        Chunk::Geometry::GetChunkX(position.x), Chunk::Geometry::GetSection(position.y),
+        Chunk::Geometry::GetChunkZ(position.z)
+    };
 }
 
 const Block& World::GetBlock(const Vector3<int> position) const noexcept
@@ -68,19 +196,160 @@ const Block& World::GetBlock(const Vector3<int> position) const noexcept
     return chunk->second->GetWorldBlock(position);
 }
 
+std::shared_ptr<const Chunk::SectionMesher> World::GetMesher() const noexcept
+{
+    return mesher_;
+}
+
+bool World::SetBlock(const Vector3<int> position, const Block& block)
+{
+    const Chunk::ChunkCoords coords = ChunkCoordFromPosition(position);
+    const auto chunk = chunks_.find(coords);
+    if (chunk == chunks_.end() || !chunk->second->IsInitialized()) return false;
+
+    const Vector3<int> localPosition{
+        position.x & (Chunk::Width - 1), position.y - coords.y * Chunk::Height, position.z & (Chunk::Depth - 1)
+    };
+    if (!chunk->second->SetLocalBlock(localPosition, block.GetId())) return false;
+
+    PatchBlock(position);
+    return true;
+}
+
+size_t World::GetEvictedMemoryUsage() const noexcept
+{
+    return evictedArchive_.GetUsedMemory();
+}
+
+size_t World::GetResidentMemoryUsage() const noexcept
+{
+    return residentBytes_ + archive_.GetUsedMemory();
+}
+
+void World::UpdateResidentMemory(const size_t previous, const size_t current) noexcept
+{
+    assert(residentBytes_ >= previous);
+    residentBytes_ = residentBytes_ - previous + current;
+}
+
+void World::AddMeshUser(const VertexBuffer* buffer, const size_t bytes)
+{
+    if (auto& [bufferBytes, users] = meshUsages_[buffer]; users++ == 0)
+    {
+        bufferBytes = bytes;
+        residentBytes_ += bytes;
+    }
+}
+
+void World::RemoveMeshUser(const VertexBuffer* buffer) noexcept
+{
+    const auto usage = meshUsages_.find(buffer);
+    assert(usage != meshUsages_.end());
+
+    if (--usage->second.users == 0)
+    {
+        residentBytes_ -= usage->second.bytes;
+        meshUsages_.erase(usage);
+    }
+}
+
+void World::FillRegion(const Vector3<int> min, const Vector3<int> max, const Block& block)
+{
+    const uint8_t blockId = block.GetId();
+    EditRegion(min, max, [blockId](const std::span<uint8_t> row, Vector3<int>)
+    {
+        if (std::ranges::all_of(row, [blockId](const uint8_t id) { return id == blockId; })) return false;
+
+        std::ranges::fill(row, blockId);
+        return true;
+    });
+}
+
+void World::ReplaceInRegion(const Vector3<int> min, const Vector3<int> max, const Block& from, const Block& to)
+{
+    const uint8_t fromId = from.GetId();
+    const uint8_t toId = to.GetId();
+    if (fromId == toId) return;
+
+    EditRegion(min, max, [fromId, toId](const std::span<uint8_t> row, Vector3<int>)
+    {
+        bool changed = false;
+        for (uint8_t& blockId : row)
+        {
+            if (blockId == fromId)
+            {
+                blockId = toId;
+                changed = true;
+            }
+        }
+        return changed;
+    });
+}
+
+void World::ApplyPatch(const Vector3<int> origin, const BlockPatch& patch)
+{
+    const Vector3<int> size = patch.GetSize();
+    if (size.x <= 0 || size.y <= 0 || size.z <= 0) return;
+
+    const Vector3<int> max{origin.x + size.x - 1, origin.y + size.y - 1, origin.z + size.z - 1};
+    EditRegion(origin, max, [&origin, &patch](const std::span<uint8_t> row, const Vector3<int> start)
+    {
+        const std::span<const uint8_t> source = patch.GetRow(
+            {start.x - origin.x, start.y - origin.y, start.z - origin.z}, static_cast<int>(row.size()));
+
+        bool changed = false;
+        for (size_t i = 0; i < row.size(); ++i)
+        {
+            if (source[i] != BlockPatch::Keep && source[i] != row[i])
+            {
+                row[i] = source[i];
+                changed = true;
+            }
+        }
+        return changed;
+    });
+}
+
+int World::GetSurfaceHeight(const int x, const int z) const noexcept
+{
+    const int chunkX = Chunk::Geometry::GetChunkX(x);
+    const int chunkZ = Chunk::Geometry::GetChunkZ(z);
+
+    // Chunks are only loaded this far above and below the player
+    const int maxChunkY = lastChunkCoords_.y + verticalViewDistance_ + ViewHysteresis;
+    const int minChunkY = lastChunkCoords_.y - verticalViewDistance_ - ViewHysteresis;
+
+    for (int chunkY = maxChunkY; chunkY >= minChunkY; --chunkY)
+    {
+        const auto chunk = chunks_.find({chunkX, chunkY, chunkZ});
+        if (chunk == chunks_.end()) continue;
+
+        if (const int height = chunk->second->GetSurfaceHeight(x & (Chunk::Width - 1), z & (Chunk::Depth - 1));
+            height > 0)
+        {
+            return chunkY * Chunk::Height + height;
+        }
+    }
+    return 0;
+}
+
 void World::GenerateWorld() noexcept
 {
     BOOST_LOG_TRIVIAL(debug) << "Starting World Generator";
     const auto workGroup{std::make_shared<DispatchWorkGroup>()};
 
-    for (int i = 0; i < chunkViewDistance_; i++)
+    // The world is loaded around the chunk the player starts in
+    if (const auto transform = playerTransform_.lock())
     {
-        for (int j = 0; j < chunkViewDistance_; j++)
-        {
-            const auto chunk = CreateChunk({i - chunkViewDistance_ / 2, j - chunkViewDistance_ / 2});
-            activeChunkCoords_.insert(chunk->GetCoords());
-            workGroup->AddWorkItem(CreateGenerationRequestForChunk(chunk), DispatchQueue::Background());
-        }
+        lastChunkCoords_ = ChunkCoordFromPosition(transform->GetPosition());
+    }
+
+    for (const Chunk::ChunkCoords offset : viewOffsets_)
+    {
+        const auto chunk = CreateChunk(lastChunkCoords_ + offset);
+        chunk->SetLevelOfDetail(GetLevelOfDetail(chunk->GetCoords(), lastChunkCoords_));
+        activeChunkCoords_.insert(chunk->GetCoords());
+        workGroup->AddWorkItem(CreateGenerationRequestForChunk(chunk), DispatchQueue::Background());
     }
 
     workGroup->AddCallback(GetGame()->MainDispatchQueue(), std::make_shared<DispatchWorkItem>([this]
@@ -95,8 +364,12 @@ void World::OnWorldGenerated()
 {
     BOOST_LOG_TRIVIAL(info) << "World generated";
 
-    std::vector<std::shared_ptr<Chunk>> chunks(chunks_.size());
-    std::ranges::transform(chunks_, chunks.begin(), [](auto pair) { return pair.second; });
+    // The chunks around the player are meshed first
+    std::vector<std::shared_ptr<Chunk>> chunks(viewOffsets_.size());
+    std::ranges::transform(viewOffsets_, chunks.begin(), [this](const Chunk::ChunkCoords offset)
+    {
+        return chunks_[lastChunkCoords_ + offset];
+    });
     const auto meshRequestGroup = CreateMeshRequestGroup(std::move(chunks));
 
     meshRequestGroup->AddCallback(GetGame()->MainDispatchQueue(), std::make_shared<DispatchWorkItem>([this]
@@ -106,36 +379,50 @@ void World::OnWorldGenerated()
     meshRequestGroup->Execute();
 }
 
-Chunk::ChunkData World::GenerateChunk(const std::shared_ptr<Chunk> chunk) const
+Chunk::ChunkData World::GenerateChunk(const Chunk::ChunkCoords coords)
 {
+    using Geometry = Chunk::Geometry;
+
     auto fnPerlin = FastNoise::New<FastNoise::Perlin>();
 
-    const Chunk::ChunkCoords coords = chunk->GetCoords();
-    std::vector<float> noiseOutput(Chunk::Width * Chunk::Depth);
-    fnPerlin->GenUniformGrid2D(noiseOutput.data(), coords.x * Chunk::Width, coords.y * Chunk::Depth, Chunk::Width,
-                               Chunk::Depth, 0.04f, 48295);
+    std::vector<float> noiseOutput(Geometry::Width * Geometry::Depth);
+    fnPerlin->GenUniformGrid2D(noiseOutput.data(), coords.x * Geometry::Width, coords.z * Geometry::Depth,
+                               Geometry::Width, Geometry::Depth, 0.04f, 48295);
     //fnPerlin->GenUniformGrid3D(noiseOutput.data(), 0, 0, 0, 16, 16, 16, 0.2f, 1337);
 
 
     constexpr int center = 25;
     constexpr int delta = 20;
 
-    auto blocks = std::vector<uint8_t>(Chunk::Size);
-    for (int i = 0; i < Chunk::Width; i++)
+    // The terrain height only depends on the column, so it is computed once per column instead of once per block
+    std::array<int, Geometry::Width * Geometry::Depth> targetHeights{};
+    for (int k = 0; k < Geometry::Depth; k++)
+    {
+        for (int i = 0; i < Geometry::Width; i++)
+        {
+            targetHeights[k * Geometry::Width + i] = center + static_cast<int>(
+                std::round(noiseOutput[k * Geometry::Width + i] * delta));
+        }
+    }
+
+    // Iterate in the same order as the blocks are stored. Everything below the surface is solid, so the terrain
+    // continues downwards without a bottom.
+    auto blocks = Chunk::ChunkData(Geometry::Size);
+    for (int j = 0; j < Geometry::Height; j++)
     {
-        for (int j = 0; j < Chunk::Height; j++)
+        const int y = coords.y * Geometry::Height + j;
+        for (int k = 0; k < Geometry::Depth; k++)
         {
-            for (int k = 0; k < Chunk::Depth; k++)
+            for (int i = 0; i < Geometry::Width; i++)
             {
-                const int targetHeight = center + static_cast<int>(
-                    std::round(noiseOutput[k * Chunk::Depth + i] * delta));
+                const int targetHeight = targetHeights[k * Geometry::Width + i];
                 if (targetHeight > 17)
                 {
-                    blocks[Chunk::GetFlatIndex(i, j, k)] = j < targetHeight ? (j == targetHeight - 1 ? 2 : 1) : 0;
+                    blocks[Geometry::GetFlatIndex(i, j, k)] = y < targetHeight ? (y == targetHeight - 1 ? 2 : 1) : 0;
                 }
                 else
                 {
-                    blocks[Chunk::GetFlatIndex(i, j, k)] = j < targetHeight ? 3 : 0;
+                    blocks[Geometry::GetFlatIndex(i, j, k)] = y < targetHeight ? 3 : 0;
                 }
             }
         }
@@ -143,31 +430,374 @@ Chunk::ChunkData World::GenerateChunk(const std::shared_ptr<Chunk> chunk) const
     return blocks;
 }
 
+bool World::IsWithinView(const Chunk::ChunkCoords coords, const Chunk::ChunkCoords center, const int radius,
+                         const int verticalRadius) noexcept
+{
+    const int dx = coords.x - center.x;
+    const int dz = coords.z - center.z;
+    if (std::abs(coords.y - center.y) > verticalRadius) return false;
+
+    // Half a chunk of slack rounds the circle, a radius of exactly r would leave single chunks sticking out at the axes
+    return dx * dx + dz * dz <= radius * (radius + 1);
+}
+
+size_t World::GetMoveIndex(const Chunk::ChunkCoords move) noexcept
+{
+    return static_cast<size_t>(move.x + 1 + (move.z + 1) * 3 + (move.y + 1) * 9);
+}
+
+int World::GetLevelOfDetail(const Chunk::ChunkCoords coords, const Chunk::ChunkCoords center) const noexcept
+{
+    // The chunks of a column share a level, so the borders between chunks above each other never change the level
+    const int distance = std::max(std::abs(coords.x - center.x), std::abs(coords.z - center.z));
+
+    int level = 0;
+    for (int limit = detailDistance_; distance >= limit && level < Chunk::SectionLevelOfDetail::LevelCount - 1;
+         limit *= 2)
+    {
+        ++level;
+    }
+    return level;
+}
+
+void World::SetLevelOfDetail(const std::shared_ptr<Chunk>& chunk, const int level)
+{
+    if (!chunk->SetLevelOfDetail(level)) return;
+
+    // The neighbours of a chunk without blocks do not depend on its level yet
+    if (!chunk->IsInitialized() && !chunk->IsArchived()) return;
+
+    const Chunk::ChunkCoords coords = chunk->GetCoords();
+    MarkChunkDirty(coords);
+    MarkChunkDirty(coords + Chunk::ChunkCoords{1, 0, 0});
+    MarkChunkDirty(coords + Chunk::ChunkCoords{-1, 0, 0});
+    MarkChunkDirty(coords + Chunk::ChunkCoords{0, 0, 1});
+    MarkChunkDirty(coords + Chunk::ChunkCoords{0, 0, -1});
+}
+
+void World::MarkChunkDirty(const Chunk::ChunkCoords coords)
+{
+    const auto chunk = chunks_.find(coords);
+    if (chunk == chunks_.end() || !chunk->second->IsInitialized() && !chunk->second->IsArchived()) return;
+
+    bool wasClean = false;
+    for (int section = 0; section < Chunk::SectionsPerChunk; ++section)
+    {
+        wasClean |= chunk->second->MarkSectionDirty(section);
+    }
+
+    if (wasClean)
+    {
+        dirtyChunks_.push_back(chunk->second);
+    }
+}
+
+void World::MarkSectionDirty(const Vector3<int> position)
+{
+    const Chunk::ChunkCoords coords = ChunkCoordFromPosition(position);
+    const auto chunk = chunks_.find(coords);
+    if (chunk == chunks_.end()) return;
+
+    if (chunk->second->MarkSectionDirty(Chunk::Geometry::GetSection(position.y - coords.y * Chunk::Height)))
+    {
+        dirtyChunks_.push_back(chunk->second);
+    }
+}
+
+void World::PatchSection(const Vector3<int> section, const Vector3<int> position)
+{
+    const auto chunk = chunks_.find(ChunkCoordFromPosition(section));
+    if (chunk == chunks_.end()) return;
+
+    const int originY = chunk->first.y * Chunk::Height;
+    const int index = Chunk::Geometry::GetSection(section.y - originY);
+    const Vector3<int> localPosition{
+        position.x - chunk->first.x * Chunk::Width,
+        position.y - originY - index * Chunk::SectionHeight,
+        position.z - chunk->first.z * Chunk::Depth
+    };
+
+    if (!chunk->second->PatchSection(index, localPosition))
+    {
+        MarkSectionDirty(section);
+    }
+}
+
+void World::PatchBlock(const Vector3<int> position)
+{
+    PatchSection(position, position);
+
+    // Blocks on the border of a section also change the visible faces of the adjacent section. At a lower level of
+    // detail the border is as thick as a cell, as the block changes the cell seen by the adjacent section.
+    const auto chunk = chunks_.find(ChunkCoordFromPosition(position));
+    const int border = chunk != chunks_.end()
+                           ? Chunk::SectionLevelOfDetail::GetCellSize(chunk->second->GetLevelOfDetail())
+                           : 1;
+
+    const int x = position.x & (Chunk::Width - 1);
+    const int y = position.y & (Chunk::SectionHeight - 1);
+    const int z = position.z & (Chunk::Depth - 1);
+
+    if (x < border) PatchSection({position.x - x - 1, position.y, position.z}, position);
+    if (x >= Chunk::Width - border) PatchSection({position.x - x + Chunk::Width, position.y, position.z}, position);
+    if (y < border) PatchSection({position.x, position.y - y - 1, position.z}, position);
+    if (y >= Chunk::SectionHeight - border)
+    {
+        PatchSection({position.x, position.y - y + Chunk::SectionHeight, position.z}, position);
+    }
+    if (z < border) PatchSection({position.x, position.y, position.z - z - 1}, position);
+    if (z >= Chunk::Depth - border) PatchSection({position.x, position.y, position.z - z + Chunk::Depth}, position);
+}
+
+void World::RemeshDirtySections()
+{
+    if (dirtyChunks_.empty()) return;
+
+    const auto workGroup = std::make_shared<DispatchWorkGroup>();
+    for (const auto& chunk : dirtyChunks_)
+    {
+        workGroup->AddWorkItem(chunk->RegenerateDirtySections(), DispatchQueue::Background());
+    }
+    dirtyChunks_.clear();
+
+    workGroup->Execute();
+}
+
+void World::EditRegion(const Vector3<int> min, const Vector3<int> max, const Chunk::RowEdit& edit)
+{
+    using Geometry = Chunk::Geometry;
+
+    if (min.x > max.x || min.y > max.y || min.z > max.z) return;
+
+    for (int chunkY = Geometry::GetChunkY(min.y); chunkY <= Geometry::GetChunkY(max.y); ++chunkY)
+    {
+        for (int chunkZ = Geometry::GetChunkZ(min.z); chunkZ <= Geometry::GetChunkZ(max.z); ++chunkZ)
+        {
+            for (int chunkX = Geometry::GetChunkX(min.x); chunkX <= Geometry::GetChunkX(max.x); ++chunkX)
+            {
+                const auto chunk = chunks_.find({chunkX, chunkY, chunkZ});
+                if (chunk == chunks_.end() || !chunk->second->IsInitialized()) continue;
+
+                // The part of the box inside of this chunk in chunk coordinates
+                const int originX = chunkX * Chunk::Width;
+                const int chunkOriginY = chunkY * Chunk::Height;
+                const int originZ = chunkZ * Chunk::Depth;
+                const int localMinX = std::max(min.x - originX, 0);
+                const int localMaxX = std::min(max.x - originX, Chunk::Width - 1);
+                const int chunkMinY = std::max(min.y - chunkOriginY, 0);
+                const int chunkMaxY = std::min(max.y - chunkOriginY, Chunk::Height - 1);
+                const int localMinZ = std::max(min.z - originZ, 0);
+                const int localMaxZ = std::min(max.z - originZ, Chunk::Depth - 1);
+                const int border = Chunk::SectionLevelOfDetail::GetCellSize(chunk->second->GetLevelOfDetail());
+
+                for (int section = Geometry::GetSection(chunkMinY); section <= Geometry::GetSection(chunkMaxY);
+                     ++section)
+                {
+                    const int originY = chunkOriginY + section * Chunk::SectionHeight;
+                    const int localMinY = std::max(min.y - originY, 0);
+                    const int localMaxY = std::min(max.y - originY, Chunk::SectionHeight - 1);
+
+                    if (!chunk->second->EditSection(section, {localMinX, localMinY, localMinZ},
+                                                    {localMaxX, localMaxY, localMaxZ}, edit))
+                    {
+                        continue;
+                    }
+
+                    MarkSectionDirty({originX, originY, originZ});
+
+                    // Edits on the border of a section also change the visible faces of the adjacent section, at a
+                    // lower level of detail the border is as thick as a cell
+                    if (localMinX < border) MarkSectionDirty({originX - 1, originY, originZ});
+                    if (localMaxX >= Chunk::Width - border)
+                    {
+                        MarkSectionDirty({originX + Chunk::Width, originY, originZ});
+                    }
+                    if (localMinY < border) MarkSectionDirty({originX, originY - 1, originZ});
+                    if (localMaxY >= Chunk::SectionHeight - border)
+                    {
+                        MarkSectionDirty({originX, originY + Chunk::SectionHeight, originZ});
+                    }
+                    if (localMinZ < border) MarkSectionDirty({originX, originY, originZ - 1});
+                    if (localMaxZ >= Chunk::Depth - border)
+                    {
+                        MarkSectionDirty({originX, originY, originZ + Chunk::Depth});
+                    }
+                }
+            }
+        }
+    }
+}
+
 std::shared_ptr<Chunk> World::CreateChunk(Chunk::ChunkCoords coords)
 {
-    auto name = L"Chunk: " + std::to_wstring(coords.x) + L", " + std::to_wstring(coords.y);
+    auto name = L"Chunk: " + std::to_wstring(coords.x) + L", " + std::to_wstring(coords.y) + L", " +
+        std::to_wstring(coords.z);
     const std::shared_ptr<Actor> actor = GetGame()->AddActor(std::move(name));
     const std::shared_ptr<Chunk> chunk = actor->AddComponent<Chunk>(*this, coords);
     chunks_[coords] = chunk;
 
+    // Link the chunk with its existing neighbours in both directions
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dz = -1; dz <= 1; ++dz)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                if (dx == 0 && dy == 0 && dz == 0) continue;
+
+                const auto neighbour = chunks_.find(coords + Chunk::ChunkCoords{dx, dy, dz});
+                if (neighbour == chunks_.end()) continue;
+
+                chunk->SetNeighbour(dx, dy, dz, neighbour->second.get());
+                neighbour->second->SetNeighbour(-dx, -dy, -dz, chunk.get());
+            }
+        }
+    }
+
     return chunk;
 }
 
+std::shared_ptr<Chunk> World::ReloadChunk(const Chunk::ChunkCoords coords)
+{
+    const auto evicted = evictedChunks_.find(coords);
+    if (evicted == evictedChunks_.end()) return nullptr;
+
+    // Every section is a contiguous range of the chunk data
+    Chunk::ChunkData blocks(Chunk::Size);
+    for (int section = 0; section < Chunk::SectionsPerChunk; ++section)
+    {
+        evictedArchive_.Expand(evicted->second[section],
+                               std::span{blocks}.subspan(static_cast<size_t>(section) * Chunk::SectionSize,
+                                                         Chunk::SectionSize));
+        evictedArchive_.Release(evicted->second[section]);
+    }
+    evictedChunks_.erase(evicted);
+
+    if (evictedArchive_.GetUsedMemory() < maxEvictedBytes_)
+    {
+        isEvictedArchiveFull_ = false;
+    }
+
+    const auto chunk = CreateChunk(coords);
+    chunk->SetBlocks(blocks, true);
+    return chunk;
+}
+
+void World::EvictChunks()
+{
+    // The chunks report their memory as it changes and the archive keeps its own total, so both budgets are checked
+    // without visiting any chunk. Edited chunks move to the evicted archive, which has its own cap and is not
+    // measured here.
+    const auto isOverMemory = [this]
+    {
+        return GetResidentMemoryUsage() > maxResidentBytes_;
+    };
+
+    // Chunks without meshes keep their blocks and come back into view without being generated again
+    for (auto it = inactiveChunks_.begin(); it != inactiveChunks_.end() && isOverMemory(); ++it)
+    {
+        const auto& chunk = chunks_[*it];
+        if (!chunk->IsArchived() || chunk->HasPendingJobs()) continue;
+
+        chunk->ReleaseMeshes();
+    }
+
+    auto it = inactiveChunks_.begin();
+    while (it != inactiveChunks_.end() && (chunks_.size() > maxResidentChunks_ || isOverMemory()))
+    {
+        const Chunk::ChunkCoords coords = *it++;
+        const auto& chunk = chunks_[coords];
+
+        // Pending jobs still refer to the sections of the chunk, it is evicted at a later update
+        if (!chunk->IsArchived() || chunk->HasPendingJobs()) continue;
+
+        // Edited chunks can not be generated again, they stay loaded once the evicted archive is full
+        if (chunk->IsModified() && evictedArchive_.GetUsedMemory() >= maxEvictedBytes_)
+        {
+            if (!isEvictedArchiveFull_)
+            {
+                BOOST_LOG_TRIVIAL(warning) << "Evicted chunks occupy " << evictedArchive_.GetUsedMemory() << " of "
+                    << maxEvictedBytes_ << " bytes, edited chunks are no longer evicted";
+                isEvictedArchiveFull_ = true;
+            }
+            continue;
+        }
+
+        EvictChunk(coords);
+    }
+}
+
+void World::EvictChunk(const Chunk::ChunkCoords coords)
+{
+    const auto chunk = chunks_.find(coords);
+    assert(chunk != chunks_.end() && chunk->second->IsArchived());
+
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dz = -1; dz <= 1; ++dz)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                if (dx == 0 && dy == 0 && dz == 0) continue;
+
+                const auto neighbour = chunks_.find(coords + Chunk::ChunkCoords{dx, dy, dz});
+                if (neighbour == chunks_.end()) continue;
+
+                neighbour->second->SetNeighbour(-dx, -dy, -dz, nullptr);
+            }
+        }
+    }
+
+    // Unmodified chunks are generated again once they are needed
+    const Chunk::ArchiveRoots roots = chunk->second->TakeArchive();
+    if (chunk->second->IsModified())
+    {
+        Chunk::ArchiveRoots evictedRoots{};
+        Chunk::ChunkData blocks(Chunk::SectionSize);
+        for (int section = 0; section < Chunk::SectionsPerChunk; ++section)
+        {
+            archive_.Expand(roots[section], blocks);
+            evictedRoots[section] = evictedArchive_.Insert(blocks);
+        }
+        evictedChunks_.emplace(coords, evictedRoots);
+    }
+
+    for (const VoxelDag::NodeRef root : roots)
+    {
+        archive_.Release(root);
+    }
+
+    chunk->second->Destroy();
+    chunks_.erase(chunk);
+
+    if (const auto position = inactivePositions_.find(coords); position != inactivePositions_.end())
+    {
+        inactiveChunks_.erase(position->second);
+        inactivePositions_.erase(position);
+    }
+}
+
 // TODO: Notify will get called before the blocks are assigned which is wrong
 std::shared_ptr<DispatchWorkItem> World::CreateGenerationRequestForChunk(
-    std::shared_ptr<Chunk> chunk) const
+    std::shared_ptr<Chunk> chunk)
 {
     return std::make_shared<DispatchWorkItem>([this, chunk]
     {
-        auto blocks = GenerateChunk(chunk);
+        auto blocks = GenerateChunk(chunk->GetCoords());
 
         BOOST_LOG_TRIVIAL(debug) << "Generating Chunk: " << chunk;
 
-        const auto workItem = std::make_shared<DispatchWorkItem>([chunk, blocks = std::move(blocks)]()
+        const auto workItem = std::make_shared<DispatchWorkItem>([this, chunk, blocks = std::move(blocks)]()
         mutable
             {
                 chunk->SetBlocks(std::move(blocks));
                 BOOST_LOG_TRIVIAL(debug) << "Blocks assigned for chunk: " << chunk;
+
+                // The chunk left the view before its blocks were generated
+                if (inactivePositions_.contains(chunk->GetCoords()))
+                {
+                    chunk->Archive(archive_);
+                }
             });
         GetGame()->MainDispatchQueue()->Async(workItem);
     });
@@ -197,40 +827,117 @@ void World::UpdateChunks()
     const auto workGroup = std::make_shared<DispatchWorkGroup>();
     const Chunk::ChunkCoords playerCoords = ChunkCoordFromPosition(playerTransform_.lock()->GetPosition());
 
-    const std::unordered_set<Chunk::ChunkCoords, ChunkHash> previousActiveChunks = std::move(activeChunkCoords_);
-    std::vector<std::shared_ptr<Chunk>> newChunks{};
+    const Chunk::ChunkCoords move{
+        playerCoords.x - lastChunkCoords_.x, playerCoords.y - lastChunkCoords_.y, playerCoords.z - lastChunkCoords_.z
+    };
+
+    std::vector<Chunk::ChunkCoords> leavingChunks{};
+    std::vector<Chunk::ChunkCoords> enteringChunks{};
+    if (std::max({std::abs(move.x), std::abs(move.y), std::abs(move.z)}) == 1)
+    {
+        const MoveOffsets& offsets = moveOffsets_[GetMoveIndex(move)];
+
+        for (const Chunk::ChunkCoords offset : offsets.leaving)
+        {
+            if (const Chunk::ChunkCoords coords = lastChunkCoords_ + offset; activeChunkCoords_.contains(coords))
+            {
+                leavingChunks.push_back(coords);
+            }
+        }
+
+        // The distances of the levels of detail move along with the player
+        for (const Chunk::ChunkCoords offset : offsets.levelChanges)
+        {
+            if (const Chunk::ChunkCoords coords = playerCoords + offset; activeChunkCoords_.contains(coords))
+            {
+                SetLevelOfDetail(chunks_[coords], GetLevelOfDetail(coords, playerCoords));
+            }
+        }
 
-    for (int i = 0; i < chunkViewDistance_; i++)
+        enteringChunks.reserve(offsets.entering.size());
+        for (const Chunk::ChunkCoords offset : offsets.entering)
+        {
+            enteringChunks.push_back(playerCoords + offset);
+        }
+    }
+    else
     {
-        for (int j = 0; j < chunkViewDistance_; j++)
+        for (const auto& coords : activeChunkCoords_)
         {
-            const Chunk::ChunkCoords chunkCoords = Vector2(
-                i - chunkViewDistance_ / 2, j - chunkViewDistance_ / 2) + playerCoords;
+            if (!IsWithinView(coords, playerCoords, chunkViewDistance_ + ViewHysteresis,
+                              verticalViewDistance_ + ViewHysteresis))
+            {
+                leavingChunks.push_back(coords);
+                continue;
+            }
 
-            activeChunkCoords_.insert(chunkCoords);
+            SetLevelOfDetail(chunks_[coords], GetLevelOfDetail(coords, playerCoords));
+        }
 
-            // Check if chunk already exists. If it doesn't create a new one. 
-            const auto chunk = chunks_.find(chunkCoords);
-            if (chunk == chunks_.end())
+        // Every chunk in view of the previous chunk of the player is still active
+        for (const Chunk::ChunkCoords offset : viewOffsets_)
+        {
+            const Chunk::ChunkCoords chunkCoords = playerCoords + offset;
+            if (!IsWithinView(chunkCoords, lastChunkCoords_, chunkViewDistance_, verticalViewDistance_))
+            {
+                enteringChunks.push_back(chunkCoords);
+            }
+        }
+    }
+
+    for (const auto& coords : leavingChunks)
+    {
+        const auto& chunk = chunks_[coords];
+        chunk->Disable();
+        chunk->Archive(archive_);
+
+        activeChunkCoords_.erase(coords);
+        inactivePositions_[coords] = inactiveChunks_.insert(inactiveChunks_.end(), coords);
+    }
+
+    std::vector<std::shared_ptr<Chunk>> newChunks{};
+    for (const Chunk::ChunkCoords chunkCoords : enteringChunks)
+    {
+        // Chunks within the hysteresis are still active
+        if (activeChunkCoords_.contains(chunkCoords)) continue;
+
+        activeChunkCoords_.insert(chunkCoords);
+
+        // Check if chunk already exists. If it doesn't create a new one. 
+        const auto chunk = chunks_.find(chunkCoords);
+        if (chunk == chunks_.end())
+        {
+            // Edited chunks are reloaded from the archive, all others are generated again
+            if (const auto reloaded = ReloadChunk(chunkCoords))
+            {
+                newChunks.push_back(reloaded);
+            }
+            else
             {
                 const auto c = CreateChunk(chunkCoords);
                 newChunks.push_back(c);
                 workGroup->AddWorkItem(CreateGenerationRequestForChunk(c), DispatchQueue::Background());
             }
-
-            // If it does enable the chunk and add it to active chunks
-            chunks_[chunkCoords]->Enable();
         }
-    }
+        else if (const auto position = inactivePositions_.find(chunkCoords);
+            position != inactivePositions_.end())
+        {
+            inactiveChunks_.erase(position->second);
+            inactivePositions_.erase(position);
+        }
 
-    for (auto& coords : previousActiveChunks)
-    {
-        if (!activeChunkCoords_.contains(coords))
+        // If it does enable the chunk and add it to active chunks
+        const auto& activeChunk = chunks_[chunkCoords];
+        if (activeChunk->Restore(archive_))
         {
-            chunks_[coords]->Disable();
+            dirtyChunks_.push_back(activeChunk);
         }
+        SetLevelOfDetail(activeChunk, GetLevelOfDetail(chunkCoords, playerCoords));
+        activeChunk->Enable();
     }
 
+    EvictChunks();
+
     workGroup->AddCallback(GetGame()->MainDispatchQueue(),
                            std::make_shared<DispatchWorkItem>([this, newChunks = move(newChunks)]()
                            mutable
@@ -0,0 +1,72 @@
+﻿#include "pch.h"
+
+#include "BlocksEngine/Core/Math/TerrainVertex.h"
+
+using BlocksEngine::TerrainVertex;
+
+TEST(TerrainVertexTest, IsEightBytes)
+{
+    EXPECT_EQ(sizeof(TerrainVertex), 8u);
+}
+
+TEST(TerrainVertexTest, UnpacksPackedFields)
+{
+    const TerrainVertex vertex{1, 16, 7, 3, 12, 5, 42};
+
+    EXPECT_EQ(vertex.GetX(), 1u);
+    EXPECT_EQ(vertex.GetY(), 16u);
+    EXPECT_EQ(vertex.GetZ(), 7u);
+    EXPECT_EQ(vertex.GetU(), 3u);
+    EXPECT_EQ(vertex.GetV(), 12u);
+    EXPECT_EQ(vertex.GetFace(), 5u);
+    EXPECT_EQ(vertex.GetTexture(), 42u);
+}
+
+TEST(TerrainVertexTest, FieldsDoNotOverlap)
+{
+    constexpr uint32_t max = TerrainVertex::MaxCoordinate;
+
+    // Setting a single field to its maximum must leave every other field at zero
+    const TerrainVertex vertices[] = {
+        {max, 0, 0, 0, 0, 0, 0},
+        {0, max, 0, 0, 0, 0, 0},
+        {0, 0, max, 0, 0, 0, 0},
+        {0, 0, 0, max, 0, 0, 0},
+        {0, 0, 0, 0, max, 0, 0},
+        {0, 0, 0, 0, 0, TerrainVertex::MaxFace, 0},
+        {0, 0, 0, 0, 0, 0, TerrainVertex::MaxTexture}
+    };
+
+    for (size_t i = 0; i < std::size(vertices); ++i)
+    {
+        const TerrainVertex& vertex = vertices[i];
+        EXPECT_EQ(vertex.GetX(), i == 0 ? max : 0u);
+        EXPECT_EQ(vertex.GetY(), i == 1 ? max : 0u);
+        EXPECT_EQ(vertex.GetZ(), i == 2 ? max : 0u);
+        EXPECT_EQ(vertex.GetU(), i == 3 ? max : 0u);
+        EXPECT_EQ(vertex.GetV(), i == 4 ? max : 0u);
+        EXPECT_EQ(vertex.GetFace(), i == 5 ? TerrainVertex::MaxFace : 0u);
+        EXPECT_EQ(vertex.GetTexture(), i == 6 ? TerrainVertex::MaxTexture : 0u);
+    }
+}
+
+TEST(TerrainVertexTest, RoundTripsEveryPositionInASection)
+{
+    for (uint32_t y = 0; y <= 16; ++y)
+    {
+        for (uint32_t z = 0; z <= 16; ++z)
+        {
+            for (uint32_t x = 0; x <= 16; ++x)
+            {
+                const TerrainVertex vertex{x, y, z, 16 - x, 16 - z, y % 6, x * z};
+                ASSERT_EQ(vertex.GetX(), x);
+                ASSERT_EQ(vertex.GetY(), y);
+                ASSERT_EQ(vertex.GetZ(), z);
+                ASSERT_EQ(vertex.GetU(), 16 - x);
+                ASSERT_EQ(vertex.GetV(), 16 - z);
+                ASSERT_EQ(vertex.GetFace(), y % 6);
+                ASSERT_EQ(vertex.GetTexture(), x * z);
+            }
+        }
+    }
+}
@@ -0,0 +1,117 @@
+﻿#include "pch.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include "BlocksEngine/Graphics/Mesh/VertexCache.h"
+
+using BlocksEngine::VertexCache;
+
+namespace
+{
+    // A grid of size x size quads sharing the vertices of their corners
+    std::vector<uint32_t> CreateGrid(const uint32_t size)
+    {
+        std::vector<uint32_t> indices;
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                const uint32_t vertex = x + y * (size + 1);
+                indices.insert(indices.end(), {
+                                   vertex, vertex + 1, vertex + size + 1, vertex + 1, vertex + size + 2,
+                                   vertex + size + 1
+                               });
+            }
+        }
+        return indices;
+    }
+
+    // Every triangle rotated to start at its lowest vertex, sorted, so lists with the same triangles compare equal
+    std::vector<std::array<uint32_t, 3>> GetTriangles(const std::vector<uint32_t>& indices)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            std::array<uint32_t, 3> triangle{indices[i], indices[i + 1], indices[i + 2]};
+            std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+            triangles.push_back(triangle);
+        }
+        std::ranges::sort(triangles);
+        return triangles;
+    }
+}
+
+TEST(VertexCacheTest, FifoKeepsOrderOnHit)
+{
+    VertexCache cache{2, VertexCache::Policy::Fifo};
+
+    EXPECT_TRUE(cache.Access(0));
+    EXPECT_TRUE(cache.Access(1));
+    EXPECT_FALSE(cache.Access(0));
+
+    // 0 is still the oldest entry and evicted first
+    EXPECT_TRUE(cache.Access(2));
+    EXPECT_TRUE(cache.Access(0));
+}
+
+TEST(VertexCacheTest, LruRefreshesOnHit)
+{
+    VertexCache cache{2, VertexCache::Policy::Lru};
+
+    EXPECT_TRUE(cache.Access(0));
+    EXPECT_TRUE(cache.Access(1));
+    EXPECT_FALSE(cache.Access(0));
+
+    // 1 is now the least recently used entry
+    EXPECT_TRUE(cache.Access(2));
+    EXPECT_FALSE(cache.Access(0));
+}
+
+TEST(VertexCacheTest, QuadListTransformsFourVerticesPerQuad)
+{
+    std::vector<uint32_t> indices;
+    for (uint32_t vertex = 0; vertex < 400; vertex += 4)
+    {
+        indices.insert(indices.end(), {vertex, vertex + 1, vertex + 2, vertex + 1, vertex + 3, vertex + 2});
+    }
+
+    EXPECT_DOUBLE_EQ(VertexCache::GetAcmr(std::span<const uint32_t>{indices}, 16, VertexCache::Policy::Fifo), 2.0);
+    EXPECT_DOUBLE_EQ(VertexCache::GetAcmr(std::span<const uint32_t>{indices}, 16, VertexCache::Policy::Lru), 2.0);
+}
+
+TEST(VertexCacheTest, TipsifyKeepsTriangles)
+{
+    std::vector<uint32_t> indices = CreateGrid(16);
+
+    const std::vector<uint32_t> reordered = VertexCache::Tipsify(std::span<const uint32_t>{indices}, 17 * 17, 16);
+
+    EXPECT_EQ(GetTriangles(reordered), GetTriangles(indices));
+}
+
+TEST(VertexCacheTest, TipsifyReducesMissesOfShuffledGrid)
+{
+    std::vector<uint32_t> grid = CreateGrid(32);
+
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i < grid.size(); i += 3)
+    {
+        triangles.push_back({grid[i], grid[i + 1], grid[i + 2]});
+    }
+    std::ranges::shuffle(triangles, std::mt19937{42});
+
+    std::vector<uint32_t> indices;
+    for (const auto& triangle : triangles)
+    {
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+    }
+
+    const std::vector<uint32_t> reordered = VertexCache::Tipsify(std::span<const uint32_t>{indices}, 33 * 33, 16);
+
+    const double before = VertexCache::GetAcmr(std::span<const uint32_t>{indices}, 16, VertexCache::Policy::Fifo);
+    const double after = VertexCache::GetAcmr(std::span<const uint32_t>{reordered}, 16, VertexCache::Policy::Fifo);
+
+    EXPECT_GT(before, 2.5);
+    EXPECT_LT(after, 0.8);
+}
@@ -64,6 +64,13 @@ public:
     [[nodiscard]] std::shared_ptr<Game> GetGame() const noexcept;
     [[nodiscard]] std::shared_ptr<Transform> GetTransform() const noexcept;
 
+    /**
+     * \brief The point in the local space of this actor by which its translucent geometry is sorted back to front,
+     * e.g. the centre of its meshes. The origin of the actor by default.
+     */
+    [[nodiscard]] const Vector3<float>& GetSortCenter() const noexcept;
+    void SetSortCenter(const Vector3<float>& center) noexcept;
+
     //------------------------------------------------------------------------------
     // Events
     //------------------------------------------------------------------------------
@@ -71,6 +78,7 @@ public:
     void Update() const;
     void Render() const;
     void Render2D() const;
+    void RenderTranslucent() const;
     void PhysicsUpdated() const;
 
 
@@ -177,6 +185,7 @@ private:
     std::wstring name_;
     std::weak_ptr<Game> game_;
     std::shared_ptr<Transform> transform_{};
+    Vector3<float> sortCenter_{0.0f, 0.0f, 0.0f};
     std::vector<std::shared_ptr<Component>> pComponents_{};
     std::queue<std::shared_ptr<Component>> pDestroyQueue_{};
 
@@ -185,6 +194,7 @@ private:
     robin_hood::unordered_set<uint32_t> updateQueue_{};
     robin_hood::unordered_set<uint32_t> renderQueue_{};
     robin_hood::unordered_set<uint32_t> render2DQueue_{};
+    robin_hood::unordered_set<uint32_t> renderTranslucentQueue_{};
     robin_hood::unordered_set<uint32_t> physicsUpdatedQueue_{};
 
     // Component states
@@ -20,13 +20,61 @@ namespace BlocksEngine
 class BlocksEngine::Collider final : public Component
 {
 public:
+    /**
+     * \brief An axis aligned box in the local space of the actor.
+     */
+    struct Box
+    {
+        physx::PxVec3 min;
+        physx::PxVec3 max;
+    };
+
     Collider(std::vector<physx::PxVec3> vertices, std::vector<int32_t> indices);
 
+    /**
+     * \brief Creates a compound collider of boxes instead of a triangle mesh.
+     */
+    explicit Collider(std::vector<Box> boxes);
+
     void Start() override;
 
+    /**
+     * \brief Replaces the triangle mesh of this collider.
+     * The mesh is cooked on a background thread and swapped in on the main thread, an empty mesh removes the shape.
+     */
+    void SetMesh(std::vector<physx::PxVec3> vertices, std::vector<int32_t> indices);
+
+    /**
+     * \brief Replaces the shapes of this collider by one box shape per box. Boxes need no cooking, so they are attached
+     * right away and replace any mesh that is still being cooked. An empty list removes all shapes.
+     */
+    void SetBoxes(std::vector<Box> boxes);
+
+    /**
+     * \brief Removes the physics actor and all its shapes from the scene. Must be called before the actor of this
+     * collider is destroyed, as components are not notified about it. The collider can not be used afterwards.
+     */
+    void Destroy() noexcept;
+
+    /**
+     * \brief The number of shapes attached to the physics actor, one per box or a single one for a triangle mesh.
+     * Boxes passed to the constructor are counted before the collider is started.
+     */
+    [[nodiscard]] size_t GetShapeCount() const noexcept;
+
 private:
     std::vector<physx::PxVec3> vertices_;
     std::vector<int32_t> indices_;
+    std::vector<Box> boxes_;
 
     physx::PxRigidActor* actor_{nullptr};
+
+    // A single shape for a triangle mesh, one shape per box otherwise
+    std::vector<physx::PxShape*> shapes_;
+
+    // Incremented for every mesh and list of boxes, only the latest cooked mesh is attached
+    uint64_t meshVersion_{0};
+
+    void Cook(std::vector<physx::PxVec3> vertices, std::vector<int32_t> indices);
+    void DetachShapes() noexcept;
 };
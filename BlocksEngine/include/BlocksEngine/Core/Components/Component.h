@@ -62,6 +62,11 @@ public:
     virtual void Update();
     virtual void Draw();
     virtual void Draw2D();
+
+    /**
+     * \brief Draws see-through geometry after all components drawn with Draw, from the farthest actor to the nearest.
+     */
+    virtual void DrawTranslucent();
     virtual void PhysicsUpdated();
 
     [[nodiscard]] EventType GetEventTypes() const noexcept;
@@ -29,12 +29,19 @@ public:
 
     void Start() override;
     void Draw() override;
+    void DrawTranslucent() override;
 
     void SetMesh(std::shared_ptr<Mesh> mesh);
     void SetMaterial(std::shared_ptr<Material> material);
 
+    /**
+     * \brief Draws the mesh in the translucent pass after all opaque meshes, blended with what lies behind it.
+     */
+    void SetTranslucent(bool translucent);
+
 private:
     std::shared_ptr<Material> pMaterial_;
     std::shared_ptr<Mesh> pMesh_;
     std::shared_ptr<VertexConstantBuffer<DirectX::XMMATRIX>> pConstantBuffer_;
+    bool translucent_{false};
 };
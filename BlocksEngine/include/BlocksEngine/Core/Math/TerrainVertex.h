@@ -0,0 +1,92 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: TerrainVertex.h
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+namespace BlocksEngine
+{
+    struct TerrainVertex;
+}
+
+/**
+ * \brief A terrain vertex packed into 8 bytes, decoded by TerrainVS.hlsl.
+ *
+ * The first word holds, starting at the lowest bit, the position (x, y, z) and the texture coordinates (u, v) with
+ * 5 bits each, followed by the face direction with 3 bits. The second word holds the texture layer in its lowest
+ * 16 bits. Positions are relative to the section and texture coordinates are multiples of a block, so both are small
+ * integers.
+ */
+struct BlocksEngine::TerrainVertex
+{
+    static constexpr uint32_t MaxCoordinate = 31;
+    static constexpr uint32_t MaxFace = 7;
+    static constexpr uint32_t MaxTexture = 0xFFFF;
+
+    uint32_t data;
+    uint32_t texture;
+
+    constexpr TerrainVertex() noexcept = default;
+
+    /**
+     * \param x, y, z The position of the vertex, at most MaxCoordinate.
+     * \param u, v The texture coordinates of the vertex, at most MaxCoordinate.
+     * \param face The direction the face of the vertex points at, at most MaxFace.
+     * \param texture The layer of the texture array, at most MaxTexture.
+     */
+    constexpr TerrainVertex(const uint32_t x, const uint32_t y, const uint32_t z, const uint32_t u, const uint32_t v,
+                            const uint32_t face, const uint32_t texture) noexcept
+        : data{x | y << 5 | z << 10 | u << 15 | v << 20 | face << 25},
+          texture{texture}
+    {
+        assert(x <= MaxCoordinate && y <= MaxCoordinate && z <= MaxCoordinate);
+        assert(u <= MaxCoordinate && v <= MaxCoordinate);
+        assert(face <= MaxFace);
+        assert(texture <= MaxTexture);
+    }
+
+    [[nodiscard]] constexpr uint32_t GetX() const noexcept
+    {
+        return data & MaxCoordinate;
+    }
+
+    [[nodiscard]] constexpr uint32_t GetY() const noexcept
+    {
+        return data >> 5 & MaxCoordinate;
+    }
+
+    [[nodiscard]] constexpr uint32_t GetZ() const noexcept
+    {
+        return data >> 10 & MaxCoordinate;
+    }
+
+    [[nodiscard]] constexpr uint32_t GetU() const noexcept
+    {
+        return data >> 15 & MaxCoordinate;
+    }
+
+    [[nodiscard]] constexpr uint32_t GetV() const noexcept
+    {
+        return data >> 20 & MaxCoordinate;
+    }
+
+    [[nodiscard]] constexpr uint32_t GetFace() const noexcept
+    {
+        return data >> 25 & MaxFace;
+    }
+
+    [[nodiscard]] constexpr uint32_t GetTexture() const noexcept
+    {
+        return texture & MaxTexture;
+    }
+};
+
+static_assert(sizeof(BlocksEngine::TerrainVertex) == 8, "The terrain input layout expects 8 byte vertices");
@@ -11,6 +11,7 @@
 
 #include <DirectXMath.h>
 #include <iostream>
+#include <boost/container_hash/hash.hpp>
 #include <foundation/PxVec3.h>
 
 #include "BlocksEngine/Core/Math/Math.h"
@@ -169,7 +170,15 @@ struct BlocksEngine::Vector3 : Vector3Base<T>::Base
     //------------------------------------------------------------------------------
     // Hashing
     //------------------------------------------------------------------------------
-    friend std::size_t hash_value(const Vector3<T>& v);
+    friend std::size_t hash_value(const Vector3<T>& v)
+    {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, v.x);
+        boost::hash_combine(seed, v.y);
+        boost::hash_combine(seed, v.z);
+
+        return seed;
+    }
 
     //------------------------------------------------------------------------------
     // Vector operations
@@ -8,6 +8,8 @@
 // File: IndexBuffer.h
 
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -22,16 +24,40 @@ namespace BlocksEngine
 class BlocksEngine::IndexBuffer final : public Bindable
 {
 public:
-    IndexBuffer(const Graphics& gfx, UINT allocationSize, bool isStatic = true);
+    /**
+     * \brief The number of quads that fit into a quad list with 16-bit indices.
+     */
+    static constexpr UINT MaxShortQuads = 65536u / 4u;
+
+    IndexBuffer(const Graphics& gfx, UINT allocationSize, bool isStatic = true,
+                DXGI_FORMAT format = DXGI_FORMAT_R32_UINT);
     IndexBuffer(const Graphics& gfx, const std::vector<int>& indices, UINT allocationSize = 0u,
                 bool isStatic = true);
+    IndexBuffer(const Graphics& gfx, const std::vector<uint16_t>& indices, UINT allocationSize = 0u,
+                bool isStatic = true);
 
     void Bind(const Graphics& gfx) noexcept override;
 
     [[nodiscard]] UINT GetCount() const noexcept;
     [[nodiscard]] UINT GetSize() const noexcept;
+    [[nodiscard]] DXGI_FORMAT GetFormat() const noexcept;
 
     void Update(const Graphics& gfx, const std::vector<int>& indices) const;
+    void Update(const Graphics& gfx, const std::vector<uint16_t>& indices) const;
+
+    /**
+     * \brief An index buffer shared by every mesh made of quads, so those meshes only have to upload their vertices.
+     * Quad i consists of the vertices 4i to 4i + 3 and is drawn as the triangles (0, 1, 2) and (1, 3, 2).
+     * Uses 16-bit indices as long as quadCount is at most MaxShortQuads. Can be called from any thread.
+     * \param quadCount The minimum number of quads the buffer has to contain.
+     */
+    [[nodiscard]] static std::shared_ptr<IndexBuffer> GetQuadList(const Graphics& gfx, UINT quadCount);
+
+    /**
+     * \brief The indices of a quad list as used by GetQuadList.
+     */
+    template <class T>
+    [[nodiscard]] static std::vector<T> CreateQuadIndices(UINT quadCount);
 
 protected:
     // Number of indices
@@ -40,8 +66,32 @@ protected:
     // Allocated size
     UINT size_;
     bool isStatic_;
+    DXGI_FORMAT format_;
 
     Microsoft::WRL::ComPtr<ID3D11Buffer> pIndexBuffer_;
 
-    void CreateBuffer(const Graphics& gfx, const std::vector<int>* indices = nullptr);
+    void CreateBuffer(const Graphics& gfx, const void* indices = nullptr, UINT dataSize = 0u);
+    void Write(const Graphics& gfx, const void* indices, UINT dataSize) const;
 };
+
+template <class T>
+std::vector<T> BlocksEngine::IndexBuffer::CreateQuadIndices(const UINT quadCount)
+{
+    std::vector<T> indices;
+    indices.reserve(static_cast<size_t>(quadCount) * 6);
+
+    for (UINT quad = 0; quad < quadCount; ++quad)
+    {
+        const T vertex = static_cast<T>(quad * 4);
+
+        indices.push_back(vertex);
+        indices.push_back(static_cast<T>(vertex + 1));
+        indices.push_back(static_cast<T>(vertex + 2));
+
+        indices.push_back(static_cast<T>(vertex + 1));
+        indices.push_back(static_cast<T>(vertex + 3));
+        indices.push_back(static_cast<T>(vertex + 2));
+    }
+
+    return indices;
+}
@@ -9,10 +9,12 @@
 
 #pragma once
 #include <memory>
+#include <vector>
 
 
 #include "BlocksEngine/Graphics/Bindable.h"
 #include "BlocksEngine/Graphics/Mesh/IndexBuffer.h"
+#include "BlocksEngine/Graphics/Mesh/SubMesh.h"
 #include "BlocksEngine/Graphics/Mesh/Topology.h"
 #include "BlocksEngine/Graphics/Mesh/VertexBuffer.h"
 
@@ -29,11 +31,30 @@ public:
     Mesh(std::shared_ptr<VertexBuffer> vertexBuffer, std::shared_ptr<IndexBuffer> indexBuffer,
          std::shared_ptr<Topology> topology = Topology::TriangleList);
 
+    /**
+     * \brief A mesh that only draws the first indexCount indices, e.g. of a shared IndexBuffer::GetQuadList.
+     */
+    Mesh(std::shared_ptr<VertexBuffer> vertexBuffer, std::shared_ptr<IndexBuffer> indexBuffer, UINT indexCount,
+         std::shared_ptr<Topology> topology = Topology::TriangleList);
+
     void Bind(const Graphics& gfx) noexcept override;
     [[nodiscard]] UINT GetCount() const noexcept;
 
+    /**
+     * \brief The ranges of indices drawn instead of the first GetCount() indices, empty to draw the whole mesh.
+     */
+    [[nodiscard]] const std::vector<SubMesh>& GetSubMeshes() const noexcept;
+
+    /**
+     * \brief Splits the mesh into ranges the renderer can cull on their own, e.g. after quads were added to or
+     * removed from a vertex buffer with spare room. Must be called on the main thread.
+     */
+    void SetSubMeshes(std::vector<SubMesh> subMeshes) noexcept;
+
 private:
     std::shared_ptr<VertexBuffer> pVertexBuffer_;
     std::shared_ptr<IndexBuffer> pIndexBuffer_;
     std::shared_ptr<Topology> pTopology_;
+    UINT count_;
+    std::vector<SubMesh> subMeshes_;
 };
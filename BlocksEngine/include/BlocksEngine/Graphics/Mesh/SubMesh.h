@@ -0,0 +1,43 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: SubMesh.h
+
+#pragma once
+
+#include "BlocksEngine/Core/Math/Vector3.h"
+
+namespace BlocksEngine
+{
+    struct SubMesh;
+}
+
+/**
+ * \brief A contiguous range of indices of a mesh whose triangles all face the same direction.
+ *
+ * The range is skipped as a whole if the camera lies behind the planes of all its triangles.
+ */
+struct BlocksEngine::SubMesh
+{
+    UINT startIndex{0};
+    UINT indexCount{0};
+
+    // The direction all triangles face in the space of the mesh, zero if they face different directions
+    Vector3<float> normal{Vector3<float>::Zero};
+
+    // The smallest distance of a triangle plane to the origin of the mesh along the normal
+    float minDistance{0.0f};
+
+    /**
+     * \brief Whether any triangle of the range faces the camera.
+     * \param camera The position of the camera in the space of the mesh.
+     */
+    [[nodiscard]] bool IsFacing(const Vector3<float>& camera) const noexcept
+    {
+        return normal == Vector3<float>::Zero || normal.Dot(camera) > minDistance;
+    }
+};
@@ -8,6 +8,8 @@
 // File: VertexBuffer.h
 
 #pragma once
+#include <cassert>
+#include <span>
 #include <vector>
 
 #include "BlocksEngine/DebugUtility/DxgiInfoManager.h"
@@ -44,7 +46,31 @@ public:
 
     void Bind(const Graphics& gfx) noexcept override;
 
+    /**
+     * \brief Overwrites a range of the vertices in place. Must be called on the main thread.
+     * \param first The index of the first vertex to overwrite.
+     * \param vertices The new vertices, they have to be of the same type the buffer was created with.
+     */
+    template <class T>
+    void Update(const Graphics& gfx, UINT first, std::span<const T> vertices) const;
+
 protected:
     UINT stride_;
     Microsoft::WRL::ComPtr<ID3D11Buffer> pVertexBuffer_;
 };
+
+template <class T>
+void BlocksEngine::VertexBuffer::Update(const Graphics& gfx, const UINT first, const std::span<const T> vertices) const
+{
+    assert(sizeof T == stride_);
+
+    D3D11_BOX box{};
+    box.left = first * stride_;
+    box.right = static_cast<UINT>((first + vertices.size()) * stride_);
+    box.top = 0u;
+    box.bottom = 1u;
+    box.front = 0u;
+    box.back = 1u;
+
+    gfx.GetContext().UpdateSubresource(pVertexBuffer_.Get(), 0u, &box, vertices.data(), 0u, 0u);
+}
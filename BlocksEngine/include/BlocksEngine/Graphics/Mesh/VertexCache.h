@@ -0,0 +1,202 @@
+﻿// 
+// Copyright (c) 2021, Severin Goddon & Jorge Paravicini
+// All rights reserved.
+// 
+// This source code is licensed under the MIT-style license found in LICENSE file in the root directory of this source tree.
+// 
+// Author: Jorge Paravicini
+// File: VertexCache.h
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+
+namespace BlocksEngine
+{
+    class VertexCache;
+}
+
+/**
+ * \brief Simulates the post-transform vertex cache of a GPU, so the vertex reuse of an index list can be measured
+ * without drawing it, and reorders triangles to make better use of the cache.
+ *
+ * A triangle only transforms the vertices that are missing from the cache. The average cache miss ratio (ACMR) is the
+ * number of transformed vertices per triangle: 3 without any reuse and about 0.5 for large regular grids. Quads that
+ * share no vertices, like the ones of the shared quad list, never go below 2.
+ */
+class BlocksEngine::VertexCache
+{
+public:
+    /**
+     * \brief Whether a hit moves a vertex to the front of the cache. Hardware caches are usually FIFO.
+     */
+    enum class Policy
+    {
+        Fifo,
+        Lru
+    };
+
+    /**
+     * \param size The number of vertices the cache holds.
+     * \param policy The entry evicted once the cache is full.
+     */
+    VertexCache(size_t size, Policy policy);
+
+    /**
+     * \brief Looks up a vertex and inserts it if it is missing.
+     * \return Whether the vertex was missing and had to be transformed.
+     */
+    bool Access(uint32_t vertex);
+
+    /**
+     * \brief The average cache miss ratio of a triangle list drawn with an empty cache.
+     * \return Zero for an empty list.
+     */
+    template <class T>
+    [[nodiscard]] static double GetAcmr(std::span<const T> indices, size_t size, Policy policy);
+
+    /**
+     * \brief Reorders the triangles of a triangle list for a cache of the given size with Tipsify (Sander, Nehab and
+     * Barczak, 2007). Runs in linear time, fans around vertices that are still in the cache and jumps to the
+     * vertices emitted most recently once a fan runs out. The triangles keep their winding.
+     * \param indices The triangle list to reorder.
+     * \param vertexCount The number of vertices the indices refer to.
+     * \param size The number of vertices of the cache to optimize for.
+     */
+    template <class T>
+    [[nodiscard]] static std::vector<T> Tipsify(std::span<const T> indices, size_t vertexCount, size_t size);
+
+private:
+    size_t size_;
+    Policy policy_;
+
+    // The most recent entry first
+    std::deque<uint32_t> entries_;
+};
+
+template <class T>
+double BlocksEngine::VertexCache::GetAcmr(const std::span<const T> indices, const size_t size, const Policy policy)
+{
+    if (indices.size() < 3) return 0.0;
+
+    VertexCache cache{size, policy};
+    size_t misses = 0;
+    for (const T index : indices)
+    {
+        misses += cache.Access(static_cast<uint32_t>(index));
+    }
+    return static_cast<double>(misses) / static_cast<double>(indices.size() / 3);
+}
+
+template <class T>
+std::vector<T> BlocksEngine::VertexCache::Tipsify(const std::span<const T> indices, const size_t vertexCount,
+                                                  const size_t size)
+{
+    const size_t triangleCount = indices.size() / 3;
+
+    // The triangles around every vertex, the ones of vertex v lie between offsets[v] and offsets[v + 1]
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (const T index : indices)
+    {
+        ++offsets[static_cast<size_t>(index) + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        offsets[v + 1] += offsets[v];
+    }
+
+    std::vector<uint32_t> triangles(triangleCount * 3);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+    {
+        triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    // The triangles of every vertex that are not emitted yet and the time it entered the simulated cache
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        liveTriangles[v] = offsets[v + 1] - offsets[v];
+    }
+    std::vector<size_t> cacheTimes(vertexCount, 0);
+    size_t time = size + 1;
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> candidates;
+
+    std::vector<T> result;
+    result.reserve(triangleCount * 3);
+
+    // Vertices below the cursor have no live triangles left, unless they are reached through the dead end stack
+    size_t cursor = 0;
+    int64_t fan = vertexCount > 0 ? 0 : -1;
+
+    while (fan >= 0)
+    {
+        candidates.clear();
+        for (uint32_t i = offsets[fan]; i < offsets[fan + 1]; ++i)
+        {
+            const uint32_t triangle = triangles[i];
+            if (emitted[triangle]) continue;
+            emitted[triangle] = true;
+
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                const T index = indices[triangle * 3 + corner];
+                const auto v = static_cast<uint32_t>(index);
+
+                result.push_back(index);
+                deadEnds.push_back(v);
+                candidates.push_back(v);
+                --liveTriangles[v];
+
+                if (time - cacheTimes[v] > size)
+                {
+                    cacheTimes[v] = time++;
+                }
+            }
+        }
+
+        // The next fan is the candidate that stays in the cache for all of its remaining triangles and entered it first
+        fan = -1;
+        size_t bestPriority = 0;
+        for (const uint32_t v : candidates)
+        {
+            if (liveTriangles[v] == 0) continue;
+
+            size_t priority = 1;
+            if (const size_t age = time - cacheTimes[v]; age + 2 * liveTriangles[v] <= size)
+            {
+                priority = age;
+            }
+
+            if (priority > bestPriority)
+            {
+                fan = v;
+                bestPriority = priority;
+            }
+        }
+
+        if (fan >= 0) continue;
+
+        // The recently emitted vertices are likely still in the cache, otherwise continue with the lowest vertex left
+        while (!deadEnds.empty() && fan < 0)
+        {
+            const uint32_t v = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangles[v] > 0) fan = v;
+        }
+
+        while (cursor < vertexCount && fan < 0)
+        {
+            if (liveTriangles[cursor] > 0) fan = static_cast<int64_t>(cursor);
+            ++cursor;
+        }
+    }
+
+    return result;
+}
@@ -21,7 +21,8 @@ enum class BlocksEngine::EventType
     Update = 1,
     Render = 2,
     Render2D = 4,
-    PhysicsUpdated = 8
+    PhysicsUpdated = 8,
+    RenderTranslucent = 16
 };
 
 inline BlocksEngine::EventType operator|(BlocksEngine::EventType a, BlocksEngine::EventType b)
@@ -127,6 +127,7 @@ private:
     void Update();
     void Render() const;
     void Render2D() const;
+    void RenderTranslucent() const;
     void PhysicsUpdate() const;
     void PhysicsUpdated() const;
     static std::optional<int> ProcessApplicationMessages() noexcept;
@@ -142,8 +143,15 @@ private:
     robin_hood::unordered_set<uint32_t> updateQueue_{};
     robin_hood::unordered_set<uint32_t> renderQueue_{};
     robin_hood::unordered_set<uint32_t> render2DQueue_{};
+    robin_hood::unordered_set<uint32_t> renderTranslucentQueue_{};
     robin_hood::unordered_set<uint32_t> physicsUpdatedQueue_{};
 
+    // Blends see-through geometry with everything drawn before it
+    Microsoft::WRL::ComPtr<ID3D11BlendState> pTranslucentBlendState_{};
+
+    // Tests translucent geometry against the depth buffer without writing to it
+    Microsoft::WRL::ComPtr<ID3D11DepthStencilState> pTranslucentDepthState_{};
+
     void DestroyRequestedActors();
 
     // Rendering loop Timer
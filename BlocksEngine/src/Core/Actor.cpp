@@ -45,6 +45,16 @@ std::shared_ptr<Transform> Actor::GetTransform() const noexcept
     return transform_;
 }
 
+const Vector3<float>& Actor::GetSortCenter() const noexcept
+{
+    return sortCenter_;
+}
+
+void Actor::SetSortCenter(const Vector3<float>& center) noexcept
+{
+    sortCenter_ = center;
+}
+
 void Actor::SetEventTypeForComponent(const Component& component, EventType eventTypes)
 {
     assert(
@@ -65,6 +75,11 @@ void Actor::SetEventTypeForComponent(const Component& component, EventType event
         render2DQueue_.erase(component.GetIndex());
     }
 
+    if ((eventTypes & EventType::RenderTranslucent) == EventType::None)
+    {
+        renderTranslucentQueue_.erase(component.GetIndex());
+    }
+
     if ((eventTypes & EventType::PhysicsUpdated) == EventType::None)
     {
         physicsUpdatedQueue_.erase(component.GetIndex());
@@ -85,6 +100,11 @@ void Actor::SetEventTypeForComponent(const Component& component, EventType event
         render2DQueue_.insert(component.GetIndex());
     }
 
+    if ((eventTypes & EventType::RenderTranslucent) == EventType::RenderTranslucent)
+    {
+        renderTranslucentQueue_.insert(component.GetIndex());
+    }
+
     if ((eventTypes & EventType::PhysicsUpdated) == EventType::PhysicsUpdated)
     {
         physicsUpdatedQueue_.insert(component.GetIndex());
@@ -103,6 +123,10 @@ void Actor::SetEventTypeForComponent(const Component& component, EventType event
     {
         componentEvent |= EventType::Render2D;
     }
+    if (!renderTranslucentQueue_.empty())
+    {
+        componentEvent |= EventType::RenderTranslucent;
+    }
     if (!physicsUpdatedQueue_.empty())
     {
         componentEvent |= EventType::PhysicsUpdated;
@@ -119,6 +143,7 @@ void Actor::SetComponentEnabled(const Component& component, const bool enabled)
         updateQueue_.erase(component.GetIndex());
         renderQueue_.erase(component.GetIndex());
         render2DQueue_.erase(component.GetIndex());
+        renderTranslucentQueue_.erase(component.GetIndex());
         physicsUpdatedQueue_.erase(component.GetIndex());
     }
     else
@@ -177,6 +202,22 @@ void Actor::Render2D() const
     }
 }
 
+void Actor::RenderTranslucent() const
+{
+    for (const int componentId : renderTranslucentQueue_)
+    {
+        if (const auto& component = pComponents_[componentId])
+        {
+            component->DrawTranslucent();
+        }
+        else
+        {
+            // TODO: Same as in game don't abort...
+            abort();
+        }
+    }
+}
+
 void Actor::PhysicsUpdated() const
 {
     for (const int componentId : physicsUpdatedQueue_)
@@ -14,6 +14,11 @@ Collider::Collider(std::vector<physx::PxVec3> vertices, std::vector<int32_t> ind
 {
 }
 
+Collider::Collider(std::vector<Box> boxes)
+    : boxes_{std::move(boxes)}
+{
+}
+
 void Collider::Start()
 {
     GetTransform()->AddSignalOnMove([this](const Vector3<float>& pos)
@@ -31,37 +36,121 @@ void Collider::Start()
         }
     });
 
-    const auto workItem = std::make_shared<DispatchWorkItem>([this]
+    const auto transform = physx::PxTransform{GetTransform()->GetPosition(), GetTransform()->GetOrientation()};
+    actor_ = GetGame()->GetPhysics().GetPhysics().createRigidStatic(transform);
+    GetGame()->GetPhysics().GetScene().addActor(*actor_);
+
+    if (boxes_.empty())
+    {
+        Cook(std::move(vertices_), std::move(indices_));
+    }
+    else
     {
-        physx::PxTriangleMeshDesc meshDesc;
-        meshDesc.points.count = vertices_.size();
-        meshDesc.points.stride = sizeof physx::PxVec3;
-        meshDesc.points.data = vertices_.data();
+        SetBoxes(std::move(boxes_));
+    }
+}
 
-        meshDesc.triangles.count = indices_.size() / 3;
-        meshDesc.triangles.stride = 3 * sizeof int32_t;
-        meshDesc.triangles.data = indices_.data();
+void Collider::SetMesh(std::vector<physx::PxVec3> vertices, std::vector<int32_t> indices)
+{
+    Cook(std::move(vertices), std::move(indices));
+}
+
+void Collider::SetBoxes(std::vector<Box> boxes)
+{
+    // Meshes that are still being cooked are discarded once they are done
+    ++meshVersion_;
+    DetachShapes();
+
+    auto& physics = GetGame()->GetPhysics();
+    shapes_.reserve(boxes.size());
+
+    for (const Box& box : boxes)
+    {
+        const physx::PxVec3 halfExtents = (box.max - box.min) * 0.5f;
+        physx::PxShape* shape = physics.GetPhysics().createShape(physx::PxBoxGeometry{halfExtents},
+                                                                 physics.DefaultMaterial());
+        shape->setLocalPose(physx::PxTransform{box.min + halfExtents});
+        actor_->attachShape(*shape);
+        shapes_.push_back(shape);
+    }
+}
+
+void Collider::Destroy() noexcept
+{
+    // Meshes that are still being cooked are discarded once they are done
+    ++meshVersion_;
+    if (!actor_) return;
+
+    DetachShapes();
+    GetGame()->GetPhysics().GetScene().removeActor(*actor_);
+    actor_->release();
+    actor_ = nullptr;
+}
 
-        physx::PxDefaultMemoryOutputStream writeBuffer;
-        if (!GetGame()->GetPhysics().GetCooking().cookTriangleMesh(meshDesc, writeBuffer))
+size_t Collider::GetShapeCount() const noexcept
+{
+    return actor_ ? shapes_.size() : boxes_.size();
+}
+
+void Collider::Cook(std::vector<physx::PxVec3> vertices, std::vector<int32_t> indices)
+{
+    const uint64_t version = ++meshVersion_;
+
+    if (indices.empty())
+    {
+        DetachShapes();
+        return;
+    }
+
+    const auto workItem = std::make_shared<DispatchWorkItem>(
+        [this, version, vertices = std::move(vertices), indices = std::move(indices)]
         {
-            throw ENGINE_EXCEPTION("Could not cook delicacies");
-        }
+            physx::PxTriangleMeshDesc meshDesc;
+            meshDesc.points.count = vertices.size();
+            meshDesc.points.stride = sizeof physx::PxVec3;
+            meshDesc.points.data = vertices.data();
 
-        physx::PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
-        physx::PxTriangleMeshGeometry triGeom;
-        auto& physics = GetGame()->GetPhysics();
-        triGeom.triangleMesh = physics.GetPhysics().createTriangleMesh(readBuffer);
+            meshDesc.triangles.count = indices.size() / 3;
+            meshDesc.triangles.stride = 3 * sizeof int32_t;
+            meshDesc.triangles.data = indices.data();
 
-        const auto transform = physx::PxTransform{GetTransform()->GetPosition(), GetTransform()->GetOrientation()};
-        actor_ = GetGame()->GetPhysics().GetPhysics().createRigidStatic(transform);
-        GetGame()->GetPhysics().GetScene().addActor(*actor_);
+            physx::PxDefaultMemoryOutputStream writeBuffer;
+            if (!GetGame()->GetPhysics().GetCooking().cookTriangleMesh(meshDesc, writeBuffer))
+            {
+                throw ENGINE_EXCEPTION("Could not cook delicacies");
+            }
 
-        const auto shape = physics.GetPhysics().createShape(triGeom, physics.DefaultMaterial());
+            physx::PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
+            physx::PxTriangleMesh* triangleMesh = GetGame()->GetPhysics().GetPhysics().createTriangleMesh(readBuffer);
 
-        actor_->attachShape(*shape);
-        shape->release();
-    });
+            // The scene is only modified on the main thread
+            GetGame()->MainDispatchQueue()->Async(std::make_shared<DispatchWorkItem>([this, version, triangleMesh]
+            {
+                // A newer mesh was set while this one was being cooked
+                if (version == meshVersion_)
+                {
+                    auto& physics = GetGame()->GetPhysics();
+
+                    DetachShapes();
+                    physx::PxShape* shape = physics.GetPhysics().createShape(
+                        physx::PxTriangleMeshGeometry{triangleMesh}, physics.DefaultMaterial());
+                    actor_->attachShape(*shape);
+                    shapes_.push_back(shape);
+                }
+
+                triangleMesh->release();
+            }));
+        });
 
     DispatchQueue::Background()->Async(workItem);
 }
+
+void Collider::DetachShapes() noexcept
+{
+    for (physx::PxShape* shape : shapes_)
+    {
+        actor_->detachShape(*shape);
+        shape->release();
+    }
+    shapes_.clear();
+}
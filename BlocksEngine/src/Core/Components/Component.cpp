@@ -55,6 +55,10 @@ void Component::Draw2D()
 {
 }
 
+void Component::DrawTranslucent()
+{
+}
+
 void Component::PhysicsUpdated()
 {
 }
@@ -22,7 +22,7 @@ Renderer::Renderer(std::shared_ptr<Material> pMaterial, std::shared_ptr<Mesh> pM
 
 void Renderer::Start()
 {
-    SetEventTypes(EventType::Render);
+    SetEventTypes(translucent_ ? EventType::RenderTranslucent : EventType::Render);
 
     pConstantBuffer_ = std::make_shared<VertexConstantBuffer<DirectX::XMMATRIX>>(GetGame()->Graphics());
     if (pMaterial_)
@@ -48,7 +48,28 @@ void Renderer::Draw()
 
     pMaterial_->Bind(gfx);
     pMesh_->Bind(gfx);
-    gfx.GetContext().DrawIndexed(pMesh_->GetCount(), 0, 0);
+
+    const std::vector<SubMesh>& subMeshes = pMesh_->GetSubMeshes();
+    if (subMeshes.empty())
+    {
+        gfx.GetContext().DrawIndexed(pMesh_->GetCount(), 0, 0);
+        return;
+    }
+
+    // The ranges are culled against the camera position in the space of the mesh
+    const Vector3<float> camera = Vector3<float>::Transform(
+        GetGame()->MainCamera().GetActor()->GetTransform()->GetPosition(), t.Invert());
+
+    for (const SubMesh& subMesh : subMeshes)
+    {
+        if (subMesh.indexCount == 0 || !subMesh.IsFacing(camera)) continue;
+        gfx.GetContext().DrawIndexed(subMesh.indexCount, subMesh.startIndex, 0);
+    }
+}
+
+void Renderer::DrawTranslucent()
+{
+    Draw();
 }
 
 void Renderer::SetMesh(std::shared_ptr<Mesh> mesh)
@@ -62,3 +83,9 @@ void Renderer::SetMaterial(std::shared_ptr<Material> material)
     // TODO: This is not ideal at all
     pMaterial_->AddConstantBuffer(pConstantBuffer_);
 }
+
+void Renderer::SetTranslucent(const bool translucent)
+{
+    translucent_ = translucent;
+    SetEventTypes(translucent_ ? EventType::RenderTranslucent : EventType::Render);
+}
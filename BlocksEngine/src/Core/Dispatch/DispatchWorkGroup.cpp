@@ -45,6 +45,13 @@ void DispatchWorkGroup::Execute()
     hasExecutionStarted_ = true;
     lock.unlock();
 
+    // Without any work items no callback would ever complete the group
+    if (nrOfWorkItems_ == 0)
+    {
+        Notify();
+        return;
+    }
+
     while (!workItems_.empty())
     {
         const auto [queue, item] = workItems_.front();
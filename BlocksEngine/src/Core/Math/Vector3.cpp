@@ -1,8 +1,6 @@
 ﻿#include "BlocksEngine/pch.h"
 #include "BlocksEngine/Core/Math/Vector3.h"
 
-#include <boost/container_hash/hash.hpp>
-
 using namespace BlocksEngine;
 using namespace DirectX;
 
@@ -179,21 +177,6 @@ Vector3<T> Vector3<T>::operator-() const noexcept
     return r;
 }
 
-//------------------------------------------------------------------------------
-// Hashing
-//------------------------------------------------------------------------------
-
-template <class T>
-std::size_t hash_value(const Vector3<T>& v)
-{
-    std::size_t seed = 0;
-    boost::hash_combine(seed, v.x);
-    boost::hash_combine(seed, v.y);
-    boost::hash_combine(seed, v.z);
-
-    return seed;
-}
-
 //------------------------------------------------------------------------------
 // Vector operations
 //------------------------------------------------------------------------------
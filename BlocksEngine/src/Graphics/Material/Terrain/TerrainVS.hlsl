@@ -10,11 +10,16 @@ struct VsOut
     float4 pos : SV_POSITION;
 };
 
-VsOut main(const float3 pos : POSITION, const float2 tex : TEXCOORD, const uint textureIndex : TEXINDEX)
+// Decodes a BlocksEngine::TerrainVertex: x, y, z, u and v with 5 bits each followed by the face direction with
+// 3 bits in the first word, the texture layer in the lowest 16 bits of the second word.
+VsOut main(const uint2 packed : PACKED)
 {
+    const float3 pos = float3(packed.x & 0x1F, packed.x >> 5 & 0x1F, packed.x >> 10 & 0x1F);
+    const float2 tex = float2(packed.x >> 15 & 0x1F, packed.x >> 20 & 0x1F);
+
     VsOut vso;
     vso.pos = mul(float4(pos, 1), Wvp);
     vso.tex = tex;
-    vso.textureIndex = textureIndex;
+    vso.textureIndex = packed.y & 0xFFFF;
     return vso;
 }
@@ -1,16 +1,21 @@
 ﻿#include "BlocksEngine/pch.h"
 #include "BlocksEngine/Graphics/Mesh/IndexBuffer.h"
 
+#include <cassert>
+#include <mutex>
+
 #include "BlocksEngine/DebugUtility/DxgiInfoManager.h"
 #include "BlocksEngine/Exceptions/BufferException.h"
 #include "BlocksEngine/Exceptions/GraphicsException.h"
 
 // TODO: THIS REALLY NEEDS SOME UNIT TESTING
 
-BlocksEngine::IndexBuffer::IndexBuffer(const Graphics& gfx, const UINT allocationSize, const bool isStatic)
+BlocksEngine::IndexBuffer::IndexBuffer(const Graphics& gfx, const UINT allocationSize, const bool isStatic,
+                                       const DXGI_FORMAT format)
     : count_{0},
       size_{allocationSize},
-      isStatic_{isStatic}
+      isStatic_{isStatic},
+      format_{format}
 {
     CreateBuffer(gfx);
 }
@@ -19,14 +24,25 @@ BlocksEngine::IndexBuffer::IndexBuffer(const Graphics& gfx, const std::vector<in
                                        const UINT allocationSize, const bool isStatic)
     : count_{static_cast<UINT>(indices.size())},
       size_{allocationSize == 0 ? static_cast<UINT>(count_ * sizeof(int)) : allocationSize},
-      isStatic_{isStatic}
+      isStatic_{isStatic},
+      format_{DXGI_FORMAT_R32_UINT}
 {
-    CreateBuffer(gfx, &indices);
+    CreateBuffer(gfx, indices.data(), static_cast<UINT>(indices.size() * sizeof(int)));
+}
+
+BlocksEngine::IndexBuffer::IndexBuffer(const Graphics& gfx, const std::vector<uint16_t>& indices,
+                                       const UINT allocationSize, const bool isStatic)
+    : count_{static_cast<UINT>(indices.size())},
+      size_{allocationSize == 0 ? static_cast<UINT>(count_ * sizeof(uint16_t)) : allocationSize},
+      isStatic_{isStatic},
+      format_{DXGI_FORMAT_R16_UINT}
+{
+    CreateBuffer(gfx, indices.data(), static_cast<UINT>(indices.size() * sizeof(uint16_t)));
 }
 
 void BlocksEngine::IndexBuffer::Bind(const Graphics& gfx) noexcept
 {
-    gfx.GetContext().IASetIndexBuffer(pIndexBuffer_.Get(), DXGI_FORMAT_R32_UINT, 0u);
+    gfx.GetContext().IASetIndexBuffer(pIndexBuffer_.Get(), format_, 0u);
 }
 
 UINT BlocksEngine::IndexBuffer::GetCount() const noexcept
@@ -39,19 +55,57 @@ UINT BlocksEngine::IndexBuffer::GetSize() const noexcept
     return size_;
 }
 
+DXGI_FORMAT BlocksEngine::IndexBuffer::GetFormat() const noexcept
+{
+    return format_;
+}
+
 // TODO: Also needs some serious testing
 void BlocksEngine::IndexBuffer::Update(const Graphics& gfx, const std::vector<int>& indices) const
 {
-    D3D11_MAPPED_SUBRESOURCE isd;
-    gfx.GetContext().Map(pIndexBuffer_.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &isd);
-    memcpy(isd.pData, indices.data(), indices.size());
-    gfx.GetContext().Unmap(pIndexBuffer_.Get(), 0u);
+    assert(format_ == DXGI_FORMAT_R32_UINT);
+    Write(gfx, indices.data(), static_cast<UINT>(indices.size() * sizeof(int)));
+}
+
+void BlocksEngine::IndexBuffer::Update(const Graphics& gfx, const std::vector<uint16_t>& indices) const
+{
+    assert(format_ == DXGI_FORMAT_R16_UINT);
+    Write(gfx, indices.data(), static_cast<UINT>(indices.size() * sizeof(uint16_t)));
+}
+
+std::shared_ptr<BlocksEngine::IndexBuffer> BlocksEngine::IndexBuffer::GetQuadList(const Graphics& gfx,
+                                                                                  const UINT quadCount)
+{
+    static std::mutex mutex;
+    static std::shared_ptr<IndexBuffer> shortQuads;
+    static std::shared_ptr<IndexBuffer> longQuads;
+
+    std::scoped_lock lock{mutex};
+
+    // Every quad list with 16-bit indices fits into one buffer, so it is built once at its maximum size
+    if (quadCount <= MaxShortQuads)
+    {
+        if (!shortQuads)
+        {
+            shortQuads = std::make_shared<IndexBuffer>(gfx, CreateQuadIndices<uint16_t>(MaxShortQuads));
+        }
+        return shortQuads;
+    }
+
+    // Larger quad lists grow by doubling, meshes still drawing with a smaller buffer keep it alive
+    if (!longQuads || longQuads->GetCount() < quadCount * 6)
+    {
+        UINT capacity = MaxShortQuads * 2;
+        while (capacity < quadCount) capacity *= 2;
+
+        longQuads = std::make_shared<IndexBuffer>(gfx, CreateQuadIndices<int>(capacity));
+    }
+    return longQuads;
 }
 
-void BlocksEngine::IndexBuffer::CreateBuffer(const Graphics& gfx,
-                                             const std::vector<int>* const indices)
+void BlocksEngine::IndexBuffer::CreateBuffer(const Graphics& gfx, const void* const indices, const UINT dataSize)
 {
-    if (indices && indices->size() * sizeof(int) > size_)
+    if (indices && dataSize > size_)
     {
         throw BUFFER_EXCEPTION("Size of data is larger than allocation size");
     }
@@ -64,16 +118,29 @@ void BlocksEngine::IndexBuffer::CreateBuffer(const Graphics& gfx,
     ibd.CPUAccessFlags = isStatic_ ? 0u : D3D11_CPU_ACCESS_WRITE;
     ibd.MiscFlags = 0u;
     ibd.ByteWidth = size_;
-    ibd.StructureByteStride = sizeof(int);
+    ibd.StructureByteStride = format_ == DXGI_FORMAT_R16_UINT ? sizeof(uint16_t) : sizeof(int);
 
     std::optional<D3D11_SUBRESOURCE_DATA> data = std::nullopt;
 
     if (indices)
     {
         D3D11_SUBRESOURCE_DATA isd{};
-        isd.pSysMem = indices->data();
+        isd.pSysMem = indices;
         data = isd;
     }
 
-    GFX_THROW_INFO(gfx.GetDevice().CreateBuffer(&ibd, &data.value(), &pIndexBuffer_));
+    GFX_THROW_INFO(gfx.GetDevice().CreateBuffer(&ibd, data ? &data.value() : nullptr, &pIndexBuffer_));
+}
+
+void BlocksEngine::IndexBuffer::Write(const Graphics& gfx, const void* const indices, const UINT dataSize) const
+{
+    if (dataSize > size_)
+    {
+        throw BUFFER_EXCEPTION("Size of data is larger than allocation size");
+    }
+
+    D3D11_MAPPED_SUBRESOURCE isd;
+    gfx.GetContext().Map(pIndexBuffer_.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &isd);
+    memcpy(isd.pData, indices, dataSize);
+    gfx.GetContext().Unmap(pIndexBuffer_.Get(), 0u);
 }
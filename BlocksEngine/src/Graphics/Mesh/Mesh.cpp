@@ -1,6 +1,8 @@
 ﻿#include "BlocksEngine/pch.h"
 #include "BlocksEngine/Graphics/Mesh/Mesh.h"
 
+#include <cassert>
+
 #include "BlocksEngine/Core/Math/Vertex.h"
 
 
@@ -30,14 +32,26 @@ BlocksEngine::Mesh::Mesh(const Graphics& gfx)
     pVertexBuffer_ = std::make_shared<VertexBuffer>(gfx, vertices);
     pIndexBuffer_ = std::make_shared<IndexBuffer>(gfx, indices);
     pTopology_ = Topology::TriangleList;
+    count_ = pIndexBuffer_->GetCount();
 }
 
 BlocksEngine::Mesh::Mesh(std::shared_ptr<VertexBuffer> vertexBuffer, std::shared_ptr<IndexBuffer> indexBuffer,
                          std::shared_ptr<Topology> topology)
     : pVertexBuffer_{std::move(vertexBuffer)},
       pIndexBuffer_{std::move(indexBuffer)},
-      pTopology_{std::move(topology)}
+      pTopology_{std::move(topology)},
+      count_{pIndexBuffer_->GetCount()}
+{
+}
+
+BlocksEngine::Mesh::Mesh(std::shared_ptr<VertexBuffer> vertexBuffer, std::shared_ptr<IndexBuffer> indexBuffer,
+                         const UINT indexCount, std::shared_ptr<Topology> topology)
+    : pVertexBuffer_{std::move(vertexBuffer)},
+      pIndexBuffer_{std::move(indexBuffer)},
+      pTopology_{std::move(topology)},
+      count_{indexCount}
 {
+    assert(indexCount <= pIndexBuffer_->GetCount());
 }
 
 void BlocksEngine::Mesh::Bind(const Graphics& gfx) noexcept
@@ -49,5 +63,21 @@ void BlocksEngine::Mesh::Bind(const Graphics& gfx) noexcept
 
 UINT BlocksEngine::Mesh::GetCount() const noexcept
 {
-    return pIndexBuffer_->GetCount();
+    return count_;
+}
+
+const std::vector<BlocksEngine::SubMesh>& BlocksEngine::Mesh::GetSubMeshes() const noexcept
+{
+    return subMeshes_;
+}
+
+void BlocksEngine::Mesh::SetSubMeshes(std::vector<SubMesh> subMeshes) noexcept
+{
+#ifndef NDEBUG
+    for (const SubMesh& subMesh : subMeshes)
+    {
+        assert(subMesh.startIndex + subMesh.indexCount <= pIndexBuffer_->GetCount());
+    }
+#endif
+    subMeshes_ = std::move(subMeshes);
 }
@@ -0,0 +1,32 @@
+﻿#include "BlocksEngine/pch.h"
+#include "BlocksEngine/Graphics/Mesh/VertexCache.h"
+
+#include <algorithm>
+
+using namespace BlocksEngine;
+
+VertexCache::VertexCache(const size_t size, const Policy policy)
+    : size_{size},
+      policy_{policy}
+{
+}
+
+bool VertexCache::Access(const uint32_t vertex)
+{
+    if (const auto it = std::ranges::find(entries_, vertex); it != entries_.end())
+    {
+        if (policy_ == Policy::Lru)
+        {
+            entries_.erase(it);
+            entries_.push_front(vertex);
+        }
+        return false;
+    }
+
+    entries_.push_front(vertex);
+    if (entries_.size() > size_)
+    {
+        entries_.pop_back();
+    }
+    return true;
+}
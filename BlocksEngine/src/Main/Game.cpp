@@ -57,6 +57,27 @@ void Game::Initialize()
     HRESULT hr;
     GFX_THROW_INFO(Graphics().GetDevice().CreateRasterizerState(&rasterizerDesc, &rasterizer));
     //Graphics().GetContext().RSSetState(rasterizer.Get());
+
+    D3D11_BLEND_DESC blendDesc{};
+    blendDesc.RenderTarget[0].BlendEnable = TRUE;
+    blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+    blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+    blendDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+    blendDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+    blendDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+    blendDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+    blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+    GFX_THROW_INFO(Graphics().GetDevice().CreateBlendState(&blendDesc, &pTranslucentBlendState_));
+
+    // Translucent geometry is still hidden by opaque geometry in front of it, but must not hide other translucent
+    // geometry drawn after it, as the faces within a mesh are not sorted
+    D3D11_DEPTH_STENCIL_DESC depthDesc{};
+    depthDesc.DepthEnable = TRUE;
+    depthDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+    depthDesc.DepthFunc = D3D11_COMPARISON_LESS;
+
+    GFX_THROW_INFO(Graphics().GetDevice().CreateDepthStencilState(&depthDesc, &pTranslucentDepthState_));
 }
 
 
@@ -244,6 +265,11 @@ void Game::UpdateEventTypeForActor(const Actor& actor, EventType eventTypes)
         render2DQueue_.erase(actor.GetIndex());
     }
 
+    if ((eventTypes & EventType::RenderTranslucent) == EventType::None)
+    {
+        renderTranslucentQueue_.erase(actor.GetIndex());
+    }
+
     if ((eventTypes & EventType::PhysicsUpdated) == EventType::None)
     {
         physicsUpdatedQueue_.erase(actor.GetIndex());
@@ -264,6 +290,11 @@ void Game::UpdateEventTypeForActor(const Actor& actor, EventType eventTypes)
         render2DQueue_.insert(actor.GetIndex());
     }
 
+    if ((eventTypes & EventType::RenderTranslucent) == EventType::RenderTranslucent)
+    {
+        renderTranslucentQueue_.insert(actor.GetIndex());
+    }
+
     if ((eventTypes & EventType::PhysicsUpdated) == EventType::PhysicsUpdated)
     {
         physicsUpdatedQueue_.insert(actor.GetIndex());
@@ -338,11 +369,49 @@ void Game::Render() const
         }
     }
 
+    RenderTranslucent();
     Render2D();
 
     pWindow_->Present();
 }
 
+void Game::RenderTranslucent() const
+{
+    if (renderTranslucentQueue_.empty()) return;
+
+    const Vector3<float>& camera = MainCamera().GetActor()->GetTransform()->GetPosition();
+
+    // See-through geometry is blended over what lies behind it, so the farthest actors are drawn first
+    std::vector<std::pair<float, const Actor*>> actors;
+    actors.reserve(renderTranslucentQueue_.size());
+    for (const uint32_t actorId : renderTranslucentQueue_)
+    {
+        if (const auto& actor = pActors_[actorId])
+        {
+            const Vector3<float> offset = actor->GetTransform()->GetPosition() + actor->GetSortCenter() - camera;
+            actors.emplace_back(offset.Dot(offset), actor.get());
+        }
+        else
+        {
+            abort();
+        }
+    }
+
+    std::ranges::sort(actors, std::ranges::greater{}, &std::pair<float, const Actor*>::first);
+
+    ID3D11DeviceContext& context = Graphics().GetContext();
+    context.OMSetBlendState(pTranslucentBlendState_.Get(), nullptr, 0xFFFFFFFF);
+    context.OMSetDepthStencilState(pTranslucentDepthState_.Get(), 0);
+
+    for (const auto& [distance, actor] : actors)
+    {
+        actor->RenderTranslucent();
+    }
+
+    context.OMSetBlendState(nullptr, nullptr, 0xFFFFFFFF);
+    context.OMSetDepthStencilState(nullptr, 0);
+}
+
 void Game::Render2D() const
 {
     ID2D1RenderTarget& renderTarget = Graphics().Get2DRenderTarget();
@@ -421,6 +490,7 @@ void Game::DestroyRequestedActors()
         updateQueue_.erase(index);
         renderQueue_.erase(index);
         render2DQueue_.erase(index);
+        renderTranslucentQueue_.erase(index);
 
         // TODO: ????? why
         //AddActor();